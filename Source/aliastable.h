@@ -0,0 +1,140 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "defines.h"
+#include "exception.h"
+#include "log.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+// Walker's alias method, draws an index proportional to its weight in constant time
+class AliasTable
+{
+public:
+	HOST AliasTable() :
+		Count(0),
+		Version(-1)
+	{
+	}
+
+	HOST AliasTable(const AliasTable& Other)
+	{
+		*this = Other;
+	}
+
+	HOST AliasTable& AliasTable::operator = (const AliasTable& Other)
+	{
+		this->Count		= Other.Count;
+		this->Version	= Other.Version;
+
+		for (int i = 0; i < this->Count; i++)
+		{
+			this->Probability[i]	= Other.Probability[i];
+			this->Alias[i]			= Other.Alias[i];
+			this->Pdf[i]			= Other.Pdf[i];
+		}
+
+		return *this;
+	}
+
+	HOST void Build(const vector<float>& Weights)
+	{
+		// Sized for every light ID a tracer can reference, a missing entry would never be sampled
+		if ((int)Weights.size() > MAX_ALIAS_TABLE_SIZE)
+			throw(Exception(Enums::Error, "Too many weights for the alias table"));
+
+		this->Count = (int)Weights.size();
+
+		if (this->Count <= 0)
+			return;
+
+		float Sum = 0.0f;
+
+		for (int i = 0; i < this->Count; i++)
+			Sum += max(Weights[i], 0.0f);
+
+		for (int i = 0; i < this->Count; i++)
+			this->Pdf[i] = Sum > 0.0f ? max(Weights[i], 0.0f) / Sum : 1.0f / (float)this->Count;
+
+		vector<int> Small, Large;
+
+		for (int i = 0; i < this->Count; i++)
+		{
+			this->Probability[i]	= this->Pdf[i] * (float)this->Count;
+			this->Alias[i]			= i;
+
+			if (this->Probability[i] < 1.0f)
+				Small.push_back(i);
+			else
+				Large.push_back(i);
+		}
+
+		while (!Small.empty() && !Large.empty())
+		{
+			const int S = Small.back();
+			const int L = Large.back();
+
+			Small.pop_back();
+
+			this->Alias[S] = L;
+
+			this->Probability[L] -= 1.0f - this->Probability[S];
+
+			if (this->Probability[L] < 1.0f)
+			{
+				Large.pop_back();
+				Small.push_back(L);
+			}
+		}
+
+		// Whatever is left over only differs from one by round off
+		for (size_t i = 0; i < Small.size(); i++)
+			this->Probability[Small[i]] = 1.0f;
+
+		for (size_t i = 0; i < Large.size(); i++)
+			this->Probability[Large[i]] = 1.0f;
+	}
+
+	HOST_DEVICE int Sample(const float& U, float& Pdf) const
+	{
+		if (this->Count <= 0)
+		{
+			Pdf = 0.0f;
+			return -1;
+		}
+
+		const float Scaled	= U * (float)this->Count;
+		const int Bin		= min((int)Scaled, this->Count - 1);
+		const int ID		= Scaled - (float)Bin < this->Probability[Bin] ? Bin : this->Alias[Bin];
+
+		Pdf = this->Pdf[ID];
+
+		return ID;
+	}
+
+	float	Probability[MAX_ALIAS_TABLE_SIZE];
+	int		Alias[MAX_ALIAS_TABLE_SIZE];
+	float	Pdf[MAX_ALIAS_TABLE_SIZE];
+	int		Count;
+	int		Version;
+};
+
+}
@@ -20,7 +20,7 @@ namespace ExposureRender
 
 KERNEL void KrnlComputeAutoFocusDistance(float* pAutoFocusDistance, int FilmU, int FilmV, unsigned int Seed1, unsigned int Seed2)
 {
-	CRNG RNG(&Seed1, &Seed2);
+	CRNG RNG(Seed1, Seed2);
 
 	Ray Rc;
 
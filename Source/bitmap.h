@@ -23,7 +23,8 @@ class Bitmap
 {
 public:
 	HOST Bitmap() :
-		Pixels(Enums::Device, "Device Pixels")
+		Pixels(Enums::Device, "Device Pixels"),
+		HostPixels(Enums::Host, "Host Pixels")
 	{
 		DebugLog(__FUNCTION__);
 	}
@@ -34,14 +35,16 @@ public:
 	}
 
 	HOST Bitmap(const Bitmap& Other) :
-		Pixels(Enums::Device, "Device Pixels")
+		Pixels(Enums::Device, "Device Pixels"),
+		HostPixels(Enums::Host, "Host Pixels")
 	{
 		DebugLog(__FUNCTION__);
 		*this = Other;
 	}
 		
 	HOST Bitmap(const ErBitmap& Other) :
-		Pixels(Enums::Device, "Device Pixels")
+		Pixels(Enums::Device, "Device Pixels"),
+		HostPixels(Enums::Host, "Host Pixels")
 	{
 		DebugLog(__FUNCTION__);
 		*this = Other;
@@ -51,7 +54,8 @@ public:
 	{
 		DebugLog(__FUNCTION__);
 
-		this->Pixels = Other.Pixels;
+		this->Pixels		= Other.Pixels;
+		this->HostPixels	= Other.HostPixels;
 
 		return *this;
 	}
@@ -60,12 +64,25 @@ public:
 	{
 		DebugLog(__FUNCTION__);
 
-		this->Pixels = Other.Pixels;
+		this->HostPixels = Other.Pixels;
+
+		if (Cuda::DeviceAvailable())
+			this->Pixels = this->HostPixels;
 
 		return *this;
 	}
 
-	Buffer2D<ColorRGBAuc> Pixels;
+	HOST_DEVICE ColorRGBAuc operator()(const Vec2f& UV) const
+	{
+#ifdef __CUDA_ARCH__
+		return this->Pixels(UV, true);
+#else
+		return this->HostPixels(UV, true);
+#endif
+	}
+
+	Buffer2D<ColorRGBAuc>	Pixels;
+	Buffer2D<ColorRGBAuc>	HostPixels;
 };
 
 }
@@ -0,0 +1,559 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "geometry.h"
+#include "exception.h"
+#include "log.h"
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+#define BRICK_CACHE_BRICK_SIZE				32
+#define BRICK_CACHE_MIN_NO_SLOTS			64
+#define BRICK_CACHE_MAX_PREFETCH_REQUESTS	256
+
+namespace Host
+{
+
+class BrickFileHeader
+{
+public:
+	char	Magic[8];
+	int		Resolution[3];
+	int		BrickSize;
+};
+
+class BrickCacheStatistics
+{
+public:
+	HOST BrickCacheStatistics() :
+		NoSlots(0),
+		NoFaults(0),
+		NoPrefetches(0),
+		NoEvictions(0)
+	{
+	}
+
+	int			NoSlots;
+	long long	NoFaults;
+	long long	NoPrefetches;
+	long long	NoEvictions;
+};
+
+// Keeps a bounded set of bricks of a brick file in memory, loading them when sampled or ahead of time from a background thread.
+// Every brick also stores the first voxel of its neighbours, so a trilinear lookup touches a single brick.
+// Lookups take no lock, a slot version (odd while the slot is being refilled) tells readers to retry.
+class BrickCache
+{
+public:
+	HOST BrickCache(const char* pFileName, const long long& MaxBytes) :
+		File(NULL),
+		Resolution(0),
+		NoBricks(0),
+		NoMacroCells(0),
+		MacroCells(),
+		NoBrickElements((BRICK_CACHE_BRICK_SIZE + 1) * (BRICK_CACHE_BRICK_SIZE + 1) * (BRICK_CACHE_BRICK_SIZE + 1)),
+		BricksOffset(0),
+		Residency(),
+		Slots(),
+		Data(),
+		Hand(0),
+		Mutex(),
+		FileMutex(),
+		Requests(),
+		RequestMutex(),
+		RequestAvailable(),
+		Worker(),
+		Stop(false),
+		Error(),
+		NoFaults(0),
+		NoPrefetches(0),
+		NoEvictions(0)
+	{
+		DebugLog("%s: %s", __FUNCTION__, pFileName);
+
+		this->File = fopen(pFileName, "rb");
+
+		if (this->File == NULL)
+			throw(Exception(Enums::Error, "Unable to open the brick file"));
+
+		BrickFileHeader Header;
+
+		if (fread(&Header, sizeof(Header), 1, this->File) != 1 || strncmp(Header.Magic, "ERBRICKS", 8) != 0 || Header.BrickSize != BRICK_CACHE_BRICK_SIZE || Header.Resolution[0] <= 0 || Header.Resolution[1] <= 0 || Header.Resolution[2] <= 0)
+		{
+			fclose(this->File);
+			throw(Exception(Enums::Error, "Not a brick file"));
+		}
+
+		this->Resolution	= Vec3i(Header.Resolution[0], Header.Resolution[1], Header.Resolution[2]);
+		this->NoBricks		= GetNoCells(this->Resolution, BRICK_CACHE_BRICK_SIZE);
+		this->NoMacroCells	= GetNoCells(this->Resolution, MACRO_CELL_SIZE);
+
+		this->MacroCells.resize((size_t)this->NoMacroCells[0] * this->NoMacroCells[1] * this->NoMacroCells[2]);
+
+		if (fread(this->MacroCells.data(), sizeof(unsigned int), this->MacroCells.size(), this->File) != this->MacroCells.size())
+		{
+			fclose(this->File);
+			throw(Exception(Enums::Error, "The brick file is truncated"));
+		}
+
+		this->BricksOffset = sizeof(Header) + (long long)this->MacroCells.size() * sizeof(unsigned int);
+
+		const int NoBricks	= this->NoBricks[0] * this->NoBricks[1] * this->NoBricks[2];
+		const int NoSlots	= (int)min((long long)NoBricks, max(MaxBytes / (this->NoBrickElements * (long long)sizeof(unsigned short)), (long long)BRICK_CACHE_MIN_NO_SLOTS));
+
+		vector<atomic<int> >(NoBricks).swap(this->Residency);
+
+		for (int i = 0; i < NoBricks; i++)
+			this->Residency[i].store(-1);
+
+		vector<Slot>(NoSlots).swap(this->Slots);
+
+		this->Data.resize((size_t)NoSlots * this->NoBrickElements);
+
+		DebugLog("No. bricks = %d, no. slots = %d", NoBricks, NoSlots);
+
+		this->Worker = thread(&BrickCache::Work, this);
+	}
+
+	HOST ~BrickCache()
+	{
+		DebugLog(__FUNCTION__);
+
+		{
+			lock_guard<mutex> Lock(this->RequestMutex);
+			this->Stop = true;
+		}
+
+		this->RequestAvailable.notify_all();
+		this->Worker.join();
+
+		fclose(this->File);
+	}
+
+	HOST const Vec3i& GetResolution() const
+	{
+		return this->Resolution;
+	}
+
+	HOST const Vec3i& GetNoMacroCells() const
+	{
+		return this->NoMacroCells;
+	}
+
+	// Packed like Volume::HostMacroCells, maximum in the high and minimum in the low 16 bits
+	HOST unsigned int* GetMacroCells()
+	{
+		return this->MacroCells.data();
+	}
+
+	HOST BrickCacheStatistics GetStatistics() const
+	{
+		BrickCacheStatistics Statistics;
+
+		Statistics.NoSlots		= (int)this->Slots.size();
+		Statistics.NoFaults		= this->NoFaults;
+		Statistics.NoPrefetches	= this->NoPrefetches;
+		Statistics.NoEvictions	= this->NoEvictions;
+
+		return Statistics;
+	}
+
+	// Same result as Buffer3D::BrickedTrilinear, UVW is in voxels
+	HOST unsigned short Trilinear(const Vec3f& UVW)
+	{
+		int vx = (int)floorf(UVW[0]);
+		int vy = (int)floorf(UVW[1]);
+		int vz = (int)floorf(UVW[2]);
+
+		float dx = UVW[0] - vx;
+		float dy = UVW[1] - vy;
+		float dz = UVW[2] - vz;
+
+		if (vx < 0 || vx >= this->Resolution[0]) { vx = Clamp(vx, 0, this->Resolution[0] - 1); dx = 0.0f; }
+		if (vy < 0 || vy >= this->Resolution[1]) { vy = Clamp(vy, 0, this->Resolution[1] - 1); dy = 0.0f; }
+		if (vz < 0 || vz >= this->Resolution[2]) { vz = Clamp(vz, 0, this->Resolution[2] - 1); dz = 0.0f; }
+
+		const int S		= BRICK_CACHE_BRICK_SIZE;
+		const int SY	= S + 1;
+		const int SZ	= SY * SY;
+
+		const int BrickID	= ((vz / S) * this->NoBricks[1] + vy / S) * this->NoBricks[0] + vx / S;
+		const int VoxelID	= ((vz % S) * SY + vy % S) * SY + vx % S;
+
+		while (true)
+		{
+			const int SlotID = this->Residency[BrickID].load(memory_order_acquire);
+
+			if (SlotID < 0)
+			{
+				this->Load(BrickID, false);
+				continue;
+			}
+
+			Slot& Slot = this->Slots[SlotID];
+
+			const unsigned int Version = Slot.Version.load(memory_order_acquire);
+
+			if ((Version & 1) != 0 || Slot.BrickID.load(memory_order_relaxed) != BrickID)
+				continue;
+
+			const unsigned short* pV = &this->Data[(size_t)SlotID * this->NoBrickElements + VoxelID];
+
+			const unsigned short d00	= Lerp(dx, pV[0], pV[1]);
+			const unsigned short d10	= Lerp(dx, pV[SY], pV[SY + 1]);
+			const unsigned short d01	= Lerp(dx, pV[SZ], pV[SZ + 1]);
+			const unsigned short d11	= Lerp(dx, pV[SZ + SY], pV[SZ + SY + 1]);
+			const unsigned short d0		= Lerp(dy, d00, d10);
+			const unsigned short d1 	= Lerp(dy, d01, d11);
+
+			const unsigned short Intensity = Lerp(dz, d0, d1);
+
+			atomic_thread_fence(memory_order_acquire);
+
+			if (Slot.Version.load(memory_order_relaxed) != Version)
+				continue;
+
+			if (!Slot.Referenced.load(memory_order_relaxed))
+				Slot.Referenced.store(true, memory_order_relaxed);
+
+			return Intensity;
+		}
+	}
+
+	// Queues the brick that holds UVW for loading in the background, requests beyond the queue size are dropped
+	HOST void Prefetch(const Vec3f& UVW)
+	{
+		const int X = Clamp((int)floorf(UVW[0]), 0, this->Resolution[0] - 1) / BRICK_CACHE_BRICK_SIZE;
+		const int Y = Clamp((int)floorf(UVW[1]), 0, this->Resolution[1] - 1) / BRICK_CACHE_BRICK_SIZE;
+		const int Z = Clamp((int)floorf(UVW[2]), 0, this->Resolution[2] - 1) / BRICK_CACHE_BRICK_SIZE;
+
+		const int BrickID = (Z * this->NoBricks[1] + Y) * this->NoBricks[0] + X;
+
+		if (this->Residency[BrickID].load(memory_order_relaxed) >= 0)
+			return;
+
+		lock_guard<mutex> Lock(this->RequestMutex);
+
+		// A failed background load is reported on the rendering thread, just like a failed fault
+		if (this->Error)
+		{
+			const exception_ptr Error = this->Error;
+
+			this->Error = nullptr;
+
+			rethrow_exception(Error);
+		}
+
+		if (this->Requests.size() >= BRICK_CACHE_MAX_PREFETCH_REQUESTS || find(this->Requests.begin(), this->Requests.end(), BrickID) != this->Requests.end())
+			return;
+
+		this->Requests.push_back(BrickID);
+		this->RequestAvailable.notify_one();
+	}
+
+	// Splits a raw 16 bit volume into bricks and records the range of every macro cell, the raw file is read one slab of bricks at a time
+	HOST static void CreateBrickFile(const char* pRawFileName, const long long& Offset, const Vec3i& Resolution, const char* pBrickFileName)
+	{
+		DebugLog("%s: %s > %s", __FUNCTION__, pRawFileName, pBrickFileName);
+
+		if (Resolution[0] <= 0 || Resolution[1] <= 0 || Resolution[2] <= 0)
+			throw(Exception(Enums::Error, "Invalid volume resolution"));
+
+		FILE* pRaw		= fopen(pRawFileName, "rb");
+		FILE* pBricks	= fopen(pBrickFileName, "wb");
+
+		if (pRaw == NULL || pBricks == NULL)
+			Fail(pRaw, pBricks, "Unable to open the raw or brick file");
+
+		const int S = BRICK_CACHE_BRICK_SIZE;
+
+		const Vec3i NoBricks		= GetNoCells(Resolution, S);
+		const Vec3i NoMacroCells	= GetNoCells(Resolution, MACRO_CELL_SIZE);
+		const long long SliceSize	= (long long)Resolution[0] * Resolution[1];
+
+		vector<unsigned int> MacroCells((size_t)NoMacroCells[0] * NoMacroCells[1] * NoMacroCells[2]);
+		vector<unsigned short> Slab((size_t)(SliceSize * (S + 1)));
+		vector<unsigned short> Brick((S + 1) * (S + 1) * (S + 1));
+
+		BrickFileHeader Header;
+
+		memcpy(Header.Magic, "ERBRICKS", 8);
+
+		for (int i = 0; i < 3; i++)
+			Header.Resolution[i] = Resolution[i];
+
+		Header.BrickSize = S;
+
+		// The macro cells follow the header, they are written last
+		if (fwrite(&Header, sizeof(Header), 1, pBricks) != 1 || !Seek(pBricks, sizeof(Header) + (long long)MacroCells.size() * sizeof(unsigned int)))
+			Fail(pRaw, pBricks, "Unable to write the brick file");
+
+		for (int BZ = 0; BZ < NoBricks[2]; BZ++)
+		{
+			const int MinZ = BZ * S;
+			const int MaxZ = min(MinZ + S, Resolution[2] - 1);
+
+			const size_t NoVoxels = (size_t)(SliceSize * (MaxZ - MinZ + 1));
+
+			if (!Seek(pRaw, Offset + MinZ * SliceSize * (long long)sizeof(unsigned short)) || fread(Slab.data(), sizeof(unsigned short), NoVoxels, pRaw) != NoVoxels)
+				Fail(pRaw, pBricks, "Unable to read the raw file");
+
+			auto Voxel = [&](const int& X, const int& Y, const int& Z)
+			{
+				return Slab[(size_t)((Clamp(Z, MinZ, MaxZ) - MinZ) * SliceSize + (long long)Clamp(Y, 0, Resolution[1] - 1) * Resolution[0] + Clamp(X, 0, Resolution[0] - 1))];
+			};
+
+			for (int BY = 0; BY < NoBricks[1]; BY++)
+			{
+				for (int BX = 0; BX < NoBricks[0]; BX++)
+				{
+					unsigned short* pVoxel = Brick.data();
+
+					for (int Z = 0; Z <= S; Z++)
+						for (int Y = 0; Y <= S; Y++)
+							for (int X = 0; X <= S; X++)
+								*pVoxel++ = Voxel(BX * S + X, BY * S + Y, MinZ + Z);
+
+					if (fwrite(Brick.data(), sizeof(unsigned short), Brick.size(), pBricks) != Brick.size())
+						Fail(pRaw, pBricks, "Unable to write the brick file");
+				}
+			}
+
+			// Same ranges as Volume::ComputeMacroCells, including the first voxel of the next cell
+			for (int Z = MinZ / MACRO_CELL_SIZE; Z < min((MinZ + S) / MACRO_CELL_SIZE, NoMacroCells[2]); Z++)
+			{
+				for (int Y = 0; Y < NoMacroCells[1]; Y++)
+				{
+					for (int X = 0; X < NoMacroCells[0]; X++)
+					{
+						unsigned short Min = USHRT_MAX, Max = 0;
+
+						for (int VZ = Z * MACRO_CELL_SIZE; VZ <= min((Z + 1) * MACRO_CELL_SIZE, Resolution[2] - 1); VZ++)
+						{
+							for (int VY = Y * MACRO_CELL_SIZE; VY <= min((Y + 1) * MACRO_CELL_SIZE, Resolution[1] - 1); VY++)
+							{
+								for (int VX = X * MACRO_CELL_SIZE; VX <= min((X + 1) * MACRO_CELL_SIZE, Resolution[0] - 1); VX++)
+								{
+									const unsigned short Intensity = Voxel(VX, VY, VZ);
+
+									Min = min(Min, Intensity);
+									Max = max(Max, Intensity);
+								}
+							}
+						}
+
+						MacroCells[((size_t)Z * NoMacroCells[1] + Y) * NoMacroCells[0] + X] = ((unsigned int)Max << 16) | Min;
+					}
+				}
+			}
+		}
+
+		if (!Seek(pBricks, sizeof(Header)) || fwrite(MacroCells.data(), sizeof(unsigned int), MacroCells.size(), pBricks) != MacroCells.size())
+			Fail(pRaw, pBricks, "Unable to write the brick file");
+
+		fclose(pRaw);
+
+		if (fclose(pBricks) != 0)
+			throw(Exception(Enums::Error, "Unable to write the brick file"));
+	}
+
+private:
+	class Slot
+	{
+	public:
+		HOST Slot() :
+			Version(0),
+			BrickID(-1),
+			Referenced(false)
+		{
+		}
+
+		atomic<unsigned int>	Version;
+		atomic<int>				BrickID;
+		atomic<bool>			Referenced;
+	};
+
+	BrickCache(const BrickCache& Other);
+	BrickCache& operator = (const BrickCache& Other);
+
+	HOST static Vec3i GetNoCells(const Vec3i& Resolution, const int& CellSize)
+	{
+		return Vec3i((Resolution[0] + CellSize - 1) / CellSize, (Resolution[1] + CellSize - 1) / CellSize, (Resolution[2] + CellSize - 1) / CellSize);
+	}
+
+	HOST static bool Seek(FILE* pFile, const long long& Offset)
+	{
+#ifdef _WIN32
+		return _fseeki64(pFile, Offset, SEEK_SET) == 0;
+#else
+		return fseeko(pFile, (off_t)Offset, SEEK_SET) == 0;
+#endif
+	}
+
+	HOST static void Fail(FILE* pRaw, FILE* pBricks, const char* pMessage)
+	{
+		if (pRaw != NULL)
+			fclose(pRaw);
+
+		if (pBricks != NULL)
+			fclose(pBricks);
+
+		throw(Exception(Enums::Error, pMessage));
+	}
+
+	HOST void Load(const int& BrickID, const bool& Prefetch)
+	{
+		vector<unsigned short> Brick(this->NoBrickElements);
+
+		{
+			lock_guard<mutex> Lock(this->FileMutex);
+
+			// Another thread may have loaded it while we waited for the file
+			if (this->Residency[BrickID].load(memory_order_acquire) >= 0)
+				return;
+
+			if (!Seek(this->File, this->BricksOffset + (long long)BrickID * this->NoBrickElements * sizeof(unsigned short)) || fread(Brick.data(), sizeof(unsigned short), Brick.size(), this->File) != Brick.size())
+				throw(Exception(Enums::Error, "Unable to read a brick"));
+		}
+
+		lock_guard<mutex> Lock(this->Mutex);
+
+		if (this->Residency[BrickID].load(memory_order_relaxed) >= 0)
+			return;
+
+		const int SlotID = this->Evict();
+
+		Slot& Slot = this->Slots[SlotID];
+
+		Slot.Version.fetch_add(1, memory_order_acq_rel);
+
+		const int EvictedID = Slot.BrickID.load(memory_order_relaxed);
+
+		if (EvictedID >= 0)
+			this->Residency[EvictedID].store(-1, memory_order_relaxed);
+
+		Slot.BrickID.store(BrickID, memory_order_relaxed);
+
+		memcpy(&this->Data[(size_t)SlotID * this->NoBrickElements], Brick.data(), Brick.size() * sizeof(unsigned short));
+
+		Slot.Version.fetch_add(1, memory_order_release);
+		Slot.Referenced.store(true, memory_order_relaxed);
+
+		this->Residency[BrickID].store(SlotID, memory_order_release);
+
+		if (Prefetch)
+			this->NoPrefetches++;
+		else
+			this->NoFaults++;
+	}
+
+	// Clock approximation of least recently used, a slot that was sampled since the hand last passed gets another round
+	HOST int Evict()
+	{
+		while (true)
+		{
+			const int SlotID = this->Hand;
+
+			this->Hand = (this->Hand + 1) % (int)this->Slots.size();
+
+			Slot& Slot = this->Slots[SlotID];
+
+			if (Slot.BrickID.load(memory_order_relaxed) < 0)
+				return SlotID;
+
+			if (Slot.Referenced.exchange(false, memory_order_relaxed))
+				continue;
+
+			this->NoEvictions++;
+
+			return SlotID;
+		}
+	}
+
+	HOST void Work()
+	{
+		while (true)
+		{
+			int BrickID = -1;
+
+			{
+				unique_lock<mutex> Lock(this->RequestMutex);
+
+				this->RequestAvailable.wait(Lock, [this] { return this->Stop || !this->Requests.empty(); });
+
+				if (this->Stop)
+					return;
+
+				BrickID = this->Requests.front();
+				this->Requests.pop_front();
+			}
+
+			try
+			{
+				this->Load(BrickID, true);
+			}
+			catch (...)
+			{
+				lock_guard<mutex> Lock(this->RequestMutex);
+
+				if (!this->Error)
+					this->Error = current_exception();
+			}
+		}
+	}
+
+	FILE*					File;
+	Vec3i					Resolution;
+	Vec3i					NoBricks;
+	Vec3i					NoMacroCells;
+	vector<unsigned int>	MacroCells;
+	int						NoBrickElements;
+	long long				BricksOffset;
+	vector<atomic<int> >	Residency;
+	vector<Slot>			Slots;
+	vector<unsigned short>	Data;
+	int						Hand;
+	mutex					Mutex;
+	mutex					FileMutex;
+	deque<int>				Requests;
+	mutex					RequestMutex;
+	condition_variable		RequestAvailable;
+	thread					Worker;
+	bool					Stop;
+	exception_ptr			Error;
+	atomic<long long>		NoFaults;
+	atomic<long long>		NoPrefetches;
+	atomic<long long>		NoEvictions;
+};
+
+}
+
+}
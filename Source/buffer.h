@@ -15,6 +15,10 @@
 
 #include "geometry.h"
 #include "wrapper.cuh"
+#include "memorypool.h"
+#include "bufferview.h"
+
+#include <utility>
 
 namespace ExposureRender
 {
@@ -27,7 +31,8 @@ public:
 		MemoryType(MemoryType),
 		Data(NULL),
 		NoElements(0),
-		Dirty(false)
+		Dirty(false),
+		External(false)
 	{
 		this->SetName(pName);
 	}
@@ -75,7 +80,7 @@ public:
 		sprintf_s(this->FullName, MAX_CHAR_SIZE, "['%s', %s]", this->Name, MemoryTypeName);
 	}
 
-	HOST virtual int GetNoBytes() const
+	HOST virtual long long GetNoBytes() const
 	{
 		return 0;
 	}
@@ -107,12 +112,43 @@ public:
 		}
 	}
 
+protected:
+	HOST void SwapStorage(Buffer& Other)
+	{
+		std::swap(this->MemoryType, Other.MemoryType);
+		std::swap(this->Data, Other.Data);
+		std::swap(this->NoElements, Other.NoElements);
+		std::swap(this->Dirty, Other.Dirty);
+		std::swap(this->External, Other.External);
+
+		this->UpdateFullName();
+		Other.UpdateFullName();
+	}
+
+	HOST void Allocate()
+	{
+		this->Data		= (T*)MemoryPool::Get().Allocate(this->MemoryType, this->GetNoBytes());
+		this->External	= false;
+	}
+
+	// External memory is only forgotten, its owner releases it
+	HOST void Release()
+	{
+		if (!this->External)
+			MemoryPool::Get().Release(this->MemoryType, this->Data, this->GetNoBytes());
+
+		this->Data		= NULL;
+		this->External	= false;
+	}
+
+public:
 	Enums::MemoryType	MemoryType;
 	char				Name[MAX_CHAR_SIZE];
 	char				FullName[MAX_CHAR_SIZE];
 	T*					Data;
-	int					NoElements;
+	long long			NoElements;
 	mutable bool		Dirty;
+	bool				External;
 };
 
 }
@@ -64,18 +64,7 @@ public:
 		DebugLog("%s: %s", __FUNCTION__, this->GetFullName());
 
 		if (this->Data)
-		{
-			if (this->MemoryType == Enums::Host)
-			{
-				free(this->Data);
-				this->Data = NULL;
-			}
-
-#ifdef __CUDA_ARCH__
-			if (this->MemoryType == Enums::Device)
-				Cuda::Free(this->Data);
-#endif
-		}
+			this->Release();
 				
 		this->Resolution	= Vec1i(0);
 		this->NoElements	= 0;
@@ -101,7 +90,7 @@ public:
 		if (this->MemoryType == Enums::Host)
 			memset(this->Data, 0, this->GetNoBytes());
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 			Cuda::MemSet(this->Data, 0, this->GetNoElements());
 #endif
@@ -124,13 +113,7 @@ public:
 		if (this->NoElements <= 0)
 			return;
 
-		if (this->MemoryType == Enums::Host)
-			this->Data = (T*)malloc(this->GetNoBytes());
-
-#ifdef __CUDA_ARCH__
-		if (this->MemoryType == Enums::Device)
-			Cuda::Allocate(this->Data, this->GetNoElements());
-#endif
+		this->Allocate();
 
 		this->Reset();
 	}
@@ -149,13 +132,13 @@ public:
 			if (MemoryType == Enums::Host)
 				memcpy(this->Data, Data, this->GetNoBytes());
 			
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 			if (MemoryType == Enums::Device)
 				Cuda::MemCopyDeviceToHost(Data, this->Data, this->GetNoElements());
 #endif
 		}
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 		{
 			if (MemoryType == Enums::Host)
@@ -169,12 +152,12 @@ public:
 		this->Dirty = true;
 	}
 
-	HOST_DEVICE int GetNoElements(void) const
+	HOST_DEVICE long long GetNoElements(void) const
 	{
 		return this->NoElements;
 	}
 
-	HOST_DEVICE virtual int GetNoBytes(void) const
+	HOST_DEVICE virtual long long GetNoBytes(void) const
 	{
 		return this->GetNoElements() * sizeof(T);
 	}
@@ -38,6 +38,17 @@ public:
 		*this = Other;
 	}
 
+	HOST Buffer2D(Buffer2D&& Other) :
+		Buffer<T>(Other.MemoryType, Other.Name),
+		Resolution(0)
+	{
+		DebugLog("%s: Other = %s", __FUNCTION__, Other.GetFullName());
+
+		this->Swap(Other);
+
+		Other.Dirty = false;
+	}
+
 	HOST virtual ~Buffer2D(void)
 	{
 		DebugLog(__FUNCTION__);
@@ -59,6 +70,35 @@ public:
 		return *this;
 	}
 
+	// Takes over the storage of Other, which is left empty and clean
+	HOST Buffer2D& operator = (Buffer2D&& Other)
+	{
+		DebugLog("%s: this = %s, Other = %s", __FUNCTION__, this->GetFullName(), Other.GetFullName());
+
+		if (this == &Other)
+			return *this;
+
+		this->Free();
+		this->Swap(Other);
+
+		this->Dirty		= true;
+		Other.Dirty		= false;
+
+		return *this;
+	}
+
+	HOST void Swap(Buffer2D& Other)
+	{
+		this->SwapStorage(Other);
+
+		std::swap(this->Resolution, Other.Resolution);
+	}
+
+	HOST_DEVICE BufferView<T> GetView() const
+	{
+		return BufferView<T>(this->Data, Vec3i(this->Resolution[0], this->Resolution[1], 1), Vec3i(1, this->Resolution[0], this->Resolution[0] * this->Resolution[1]));
+	}
+
 	HOST void Free(void)
 	{
 		DebugLog("%s: %s", __FUNCTION__, this->GetFullName());
@@ -69,20 +109,8 @@ public:
 
 		if (this->Data)
 		{
-			if (this->MemoryType == Enums::Host)
-			{
-				free(this->Data);
-				this->Data = NULL;
-				DebugLog("Freed %s on host", MemoryString);
-			}
-
-#ifdef __CUDA_ARCH__
-			if (this->MemoryType == Enums::Device)
-			{
-				Cuda::Free(this->Data);
-				DebugLog("Freed %s on device", MemoryString);
-			}
-#endif
+			this->Release();
+			DebugLog("Released %s to the %s pool", MemoryString, this->MemoryType == Enums::Host ? "host" : "device");
 		}
 				
 		this->Resolution	= Vec2i(0);
@@ -109,7 +137,7 @@ public:
 		if (this->MemoryType == Enums::Host)
 			memset(this->Data, 0, this->GetNoBytes());
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 			Cuda::MemSet(this->Data, 0, this->GetNoElements());
 #endif
@@ -117,6 +145,20 @@ public:
 		this->Dirty = true;
 	}
 
+	HOST void SetMemoryType(const Enums::MemoryType& MemoryType)
+	{
+		DebugLog("%s: %s", __FUNCTION__, this->GetFullName());
+
+		if (this->MemoryType == MemoryType)
+			return;
+
+		this->Free();
+
+		this->MemoryType = MemoryType;
+
+		this->UpdateFullName();
+	}
+
 	HOST void Resize(const Vec2i& Resolution)
 	{
 		DebugLog("%s", __FUNCTION__);
@@ -135,25 +177,14 @@ public:
 		if (this->NoElements <= 0)
 			return;
 		
-		DebugLog("No. Elements = %d", this->NoElements);
+		DebugLog("No. Elements = %lld", this->NoElements);
 		
 		char MemoryString[MAX_CHAR_SIZE];
 		
 		this->GetMemoryString(MemoryString, Enums::MegaByte);
 
-		if (this->MemoryType == Enums::Host)
-		{
-			this->Data = (T*)malloc(this->GetNoBytes());
-			DebugLog("Allocated %s on host", MemoryString);
-		}
-
-#ifdef __CUDA_ARCH__
-		if (this->MemoryType == Enums::Device)
-		{
-			Cuda::Allocate(this->Data, this->GetNoElements());
-			DebugLog("Allocated %s on device", MemoryString);
-		}
-#endif
+		this->Allocate();
+		DebugLog("Allocated %s from the %s pool", MemoryString, this->MemoryType == Enums::Host ? "host" : "device");
 
 		this->Reset();
 	}
@@ -172,13 +203,13 @@ public:
 			if (MemoryType == Enums::Host)
 				memcpy(this->Data, Data, this->GetNoBytes());
 			
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 			if (MemoryType == Enums::Device)
 				Cuda::MemCopyDeviceToHost(Data, this->Data, this->GetNoElements());
 #endif
 		}
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 		{
 			if (MemoryType == Enums::Host)
@@ -192,12 +223,12 @@ public:
 		this->Dirty = true;
 	}
 
-	HOST_DEVICE int GetNoElements(void) const
+	HOST_DEVICE long long GetNoElements(void) const
 	{
 		return this->NoElements;
 	}
 
-	HOST_DEVICE virtual int GetNoBytes(void) const
+	HOST_DEVICE virtual long long GetNoBytes(void) const
 	{
 		return this->GetNoElements() * sizeof(T);
 	}
@@ -250,34 +281,11 @@ public:
 
 	HOST_DEVICE T& operator[](const int& ID) const
 	{
-		const int ClampedID = Clamp(ID, 0, this->NoElements - 1);
+		const long long ClampedID = Clamp((long long)ID, 0ll, this->NoElements - 1);
 		return this->Data[ClampedID];
 	}
 
 	Vec2i	Resolution;
 };
 
-class RandomSeedBuffer2D : public Buffer2D<unsigned int>
-{
-public:
-	HOST RandomSeedBuffer2D(const Enums::MemoryType& MemoryType, const char* pName) :
-		Buffer2D(MemoryType, pName)
-	{
-	}
-
-	void Resize(const Vec2i& Resolution)
-	{
-		const int NoSeeds = Resolution[0] * Resolution[1];
-
-		unsigned int* pSeeds = new unsigned int[NoSeeds];
-
-		for (int i = 0; i < NoSeeds; i++)
-			pSeeds[i] = rand();
-
-		this->Set(Enums::Host, Resolution, pSeeds);
-
-		delete[] pSeeds;
-	}
-};
-
 }
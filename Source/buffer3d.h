@@ -24,20 +24,37 @@ class EXPOSURE_RENDER_DLL Buffer3D : public Buffer<T>
 public:
 	HOST Buffer3D(const Enums::MemoryType& MemoryType = Enums::Host, const char* pName = "Buffer (3D)") :
 		Buffer<T>(MemoryType, pName),
-		Resolution(0)
+		Resolution(0),
+		Layout(Enums::LinearLayout),
+		NoBricks(0)
 	{
 		DebugLog("%s: %s", __FUNCTION__, this->GetFullName());
 	}
 
 	HOST Buffer3D(const Buffer3D& Other) :
 		Buffer<T>(),
-		Resolution(0)
+		Resolution(0),
+		Layout(Enums::LinearLayout),
+		NoBricks(0)
 	{
 		DebugLog("%s: Other = %s", __FUNCTION__, Other.GetFullName());
 		
 		*this = Other;
 	}
 
+	HOST Buffer3D(Buffer3D&& Other) :
+		Buffer<T>(Other.MemoryType, Other.Name),
+		Resolution(0),
+		Layout(Enums::LinearLayout),
+		NoBricks(0)
+	{
+		DebugLog("%s: Other = %s", __FUNCTION__, Other.GetFullName());
+
+		this->Swap(Other);
+
+		Other.Dirty = false;
+	}
+
 	HOST virtual ~Buffer3D(void)
 	{
 		DebugLog(__FUNCTION__);
@@ -50,7 +67,18 @@ public:
 		
 		if (Other.Dirty)
 		{
-			this->Set(Other.MemoryType, Other.Resolution, Other.Data);
+			if (this->Layout != Other.Layout)
+			{
+				this->Free();
+				this->Layout = Other.Layout;
+			}
+
+			// External memory in the same memory space is shared, its owner already keeps it alive for us
+			if (Other.External && Other.MemoryType == this->MemoryType)
+				this->Wrap(Other.Resolution, Other.Data);
+			else
+				this->Set(Other.MemoryType, Other.Resolution, Other.Data);
+
 			Other.Dirty = false;
 		}
 		
@@ -59,6 +87,40 @@ public:
 		return *this;
 	}
 
+	// Takes over the storage and layout of Other, which is left empty and clean
+	HOST Buffer3D& operator = (Buffer3D&& Other)
+	{
+		DebugLog("%s: this = %s, Other = %s", __FUNCTION__, this->GetFullName(), Other.GetFullName());
+
+		if (this == &Other)
+			return *this;
+
+		this->Free();
+		this->Swap(Other);
+
+		this->Dirty		= true;
+		Other.Dirty		= false;
+
+		return *this;
+	}
+
+	HOST void Swap(Buffer3D& Other)
+	{
+		this->SwapStorage(Other);
+
+		std::swap(this->Resolution, Other.Resolution);
+		std::swap(this->Layout, Other.Layout);
+		std::swap(this->NoBricks, Other.NoBricks);
+	}
+
+	HOST BufferView<T> GetView() const
+	{
+		if (this->Layout != Enums::LinearLayout)
+			throw(Exception(Enums::Error, "Only linear buffers can be viewed with strides"));
+
+		return BufferView<T>(this->Data, this->Resolution, Vec3i(1, this->Resolution[0], this->Resolution[0] * this->Resolution[1]));
+	}
+
 	HOST void Free(void)
 	{
 		DebugLog("%s: %s", __FUNCTION__, this->GetFullName());
@@ -69,23 +131,12 @@ public:
 
 		if (this->Data)
 		{
-			if (this->MemoryType == Enums::Host)
-			{
-				free(this->Data);
-				this->Data = NULL;
-				DebugLog("Freed %s on host", MemoryString);
-			}
-
-#ifdef __CUDA_ARCH__
-			if (this->MemoryType == Enums::Device)
-			{
-				Cuda::Free(this->Data);
-				DebugLog("Freed %s on device", MemoryString);
-			}
-#endif
+			DebugLog(this->External ? "Detached %s of external %s memory" : "Released %s to the %s pool", MemoryString, this->MemoryType == Enums::Host ? "host" : "device");
+			this->Release();
 		}
 				
 		this->Resolution	= Vec3i(0);
+		this->NoBricks		= Vec3i(0);
 		this->NoElements	= 0;
 		this->Dirty			= true;
 	}
@@ -109,7 +160,7 @@ public:
 		if (this->MemoryType == Enums::Host)
 			memset(this->Data, 0, this->GetNoBytes());
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 			Cuda::MemSet(this->Data, 0, this->GetNoElements());
 #endif
@@ -121,7 +172,8 @@ public:
 	{
 		DebugLog("%s", __FUNCTION__);
 		
-		if (this->Resolution == Resolution)
+		// External memory is never written to, resizing always moves to storage of our own
+		if (this->Resolution == Resolution && !this->External)
 			return;
 		else
 			this->Free();
@@ -130,30 +182,27 @@ public:
 		
 		DebugLog("Resolution = [%d x %d x %d]", this->Resolution[0], this->Resolution[1], this->Resolution[2]);
 
-		this->NoElements = this->Resolution[0] * this->Resolution[1] * this->Resolution[2];
+		if (this->Layout == Enums::BrickedLayout)
+		{
+			this->NoBricks		= Vec3i((Resolution[0] + BRICK_SIZE - 1) / BRICK_SIZE, (Resolution[1] + BRICK_SIZE - 1) / BRICK_SIZE, (Resolution[2] + BRICK_SIZE - 1) / BRICK_SIZE);
+			this->NoElements	= (long long)this->NoBricks[0] * this->NoBricks[1] * this->NoBricks[2] * (BRICK_SIZE + 1) * (BRICK_SIZE + 1) * (BRICK_SIZE + 1);
+		}
+		else
+		{
+			this->NoElements = (long long)this->Resolution[0] * this->Resolution[1] * this->Resolution[2];
+		}
 		
 		if (this->NoElements <= 0)
 			return;
 		
-		DebugLog("No. Elements = %d", this->NoElements);
+		DebugLog("No. Elements = %lld", this->NoElements);
 
 		char MemoryString[MAX_CHAR_SIZE];
 		
 		this->GetMemoryString(MemoryString, Enums::MegaByte);
 
-		if (this->MemoryType == Enums::Host)
-		{
-			this->Data = (T*)malloc(this->GetNoBytes());
-			DebugLog("Allocated %s on host", MemoryString);
-		}
-
-#ifdef __CUDA_ARCH__
-		if (this->MemoryType == Enums::Device)
-		{
-			Cuda::Allocate(this->Data, this->GetNoElements());
-			DebugLog("Allocated %s on device", MemoryString);
-		}
-#endif
+		this->Allocate();
+		DebugLog("Allocated %s from the %s pool", MemoryString, this->MemoryType == Enums::Host ? "host" : "device");
 
 		this->Reset();
 	}
@@ -172,13 +221,13 @@ public:
 			if (MemoryType == Enums::Host)
 				memcpy(this->Data, Data, this->GetNoBytes());
 			
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 			if (MemoryType == Enums::Device)
 				Cuda::MemCopyDeviceToHost(Data, this->Data, this->GetNoElements());
 #endif
 		}
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 		if (this->MemoryType == Enums::Device)
 		{
 			if (MemoryType == Enums::Host)
@@ -192,32 +241,119 @@ public:
 		this->Dirty = true;
 	}
 
-	HOST_DEVICE int GetNoElements(void) const
+	// Refers to linear data owned by someone else instead of copying it, the data has to stay valid and unchanged while it is wrapped
+	HOST void Wrap(const Vec3i& Resolution, T* Data)
+	{
+		DebugLog("%s: %s, %d x %d x %d", __FUNCTION__, this->GetFullName(), Resolution[0], Resolution[1], Resolution[2]);
+
+		this->Free();
+
+		this->Layout		= Enums::LinearLayout;
+		this->Resolution	= Resolution;
+		this->NoElements	= (long long)Resolution[0] * Resolution[1] * Resolution[2];
+
+		if (this->NoElements <= 0)
+		{
+			this->Resolution	= Vec3i(0);
+			this->NoElements	= 0;
+			return;
+		}
+
+		this->Data		= Data;
+		this->External	= true;
+		this->Dirty		= true;
+	}
+
+	HOST void SetLayout(const Enums::VoxelLayout& Layout)
+	{
+		DebugLog("%s: %s, %s", __FUNCTION__, this->GetFullName(), Layout == Enums::BrickedLayout ? "bricked" : "linear");
+
+		if (this->Layout == Layout)
+			return;
+
+		if (this->NoElements > 0 && this->MemoryType != Enums::Host)
+			throw(Exception(Enums::Error, "The voxel layout can only be changed on the host"));
+
+		const Vec3i Resolution = this->Resolution;
+
+		Buffer3D Source(Enums::Host, "Layout Conversion");
+
+		Source.Layout = this->Layout;
+
+		// External data outlives the conversion, so it is read in place
+		if (this->External)
+			Source.Wrap(Resolution, this->Data);
+		else
+			Source.Set(Enums::Host, Resolution, this->Data);
+
+		this->Free();
+		this->Layout = Layout;
+		this->Resize(Resolution);
+
+		if (this->NoElements <= 0)
+			return;
+
+		if (this->Layout == Enums::LinearLayout)
+		{
+			for (int Z = 0; Z < Resolution[2]; Z++)
+				for (int Y = 0; Y < Resolution[1]; Y++)
+					for (int X = 0; X < Resolution[0]; X++)
+						(*this)(X, Y, Z) = Source(X, Y, Z);
+
+			return;
+		}
+
+		// Every brick also stores the first voxel of its neighbours (clamped at the border), so trilinear lookups never leave a brick
+		T* pData = this->Data;
+
+		for (int BZ = 0; BZ < this->NoBricks[2]; BZ++)
+			for (int BY = 0; BY < this->NoBricks[1]; BY++)
+				for (int BX = 0; BX < this->NoBricks[0]; BX++)
+					for (int Z = 0; Z <= BRICK_SIZE; Z++)
+						for (int Y = 0; Y <= BRICK_SIZE; Y++)
+							for (int X = 0; X <= BRICK_SIZE; X++)
+								*pData++ = Source(BX * BRICK_SIZE + X, BY * BRICK_SIZE + Y, BZ * BRICK_SIZE + Z);
+	}
+
+	HOST_DEVICE long long GetNoElements(void) const
 	{
 		return this->NoElements;
 	}
 
-	HOST_DEVICE virtual int GetNoBytes(void) const
+	HOST_DEVICE virtual long long GetNoBytes(void) const
 	{
 		return this->GetNoElements() * sizeof(T);
 	}
 
+	// 64 bit, volumes of more than 2^31 voxels are addressed too
+	HOST_DEVICE long long GetID(const int& X, const int& Y, const int& Z) const
+	{
+		if (this->Layout == Enums::BrickedLayout)
+		{
+			const long long BrickID = ((long long)(Z / BRICK_SIZE) * this->NoBricks[1] + Y / BRICK_SIZE) * this->NoBricks[0] + X / BRICK_SIZE;
+			return (BrickID * (BRICK_SIZE + 1) + Z % BRICK_SIZE) * (BRICK_SIZE + 1) * (BRICK_SIZE + 1) + (Y % BRICK_SIZE) * (BRICK_SIZE + 1) + X % BRICK_SIZE;
+		}
+
+		return ((long long)Z * this->Resolution[1] + Y) * this->Resolution[0] + X;
+	}
+
 	HOST_DEVICE T& operator()(const int& X = 0, const int& Y = 0, const int& Z = 0) const
 	{
-		const Vec3i ClampedXYZ(Clamp(X, 0, this->Resolution[0] - 1), Clamp(Y, 0, this->Resolution[1] - 1), Clamp(Z, 0, this->Resolution[2] - 1));
-		return this->Data[ClampedXYZ[2] * this->Resolution[0] * this->Resolution[1] + ClampedXYZ[1] * this->Resolution[0] + ClampedXYZ[0]];
+		return this->Data[this->GetID(Clamp(X, 0, this->Resolution[0] - 1), Clamp(Y, 0, this->Resolution[1] - 1), Clamp(Z, 0, this->Resolution[2] - 1))];
 	}
 
 	HOST_DEVICE T& operator()(const Vec3i& XYZ) const
 	{
-		const Vec3i ClampedXYZ(Clamp(XYZ[0], 0, this->Resolution[0] - 1), Clamp(XYZ[1], 0, this->Resolution[1] - 1), Clamp(XYZ[2], 0, this->Resolution[2] - 1));
-		return this->Data[ClampedXYZ[2] * this->Resolution[0] * this->Resolution[1] + ClampedXYZ[1] * this->Resolution[0] + ClampedXYZ[0]];
+		return this->Data[this->GetID(Clamp(XYZ[0], 0, this->Resolution[0] - 1), Clamp(XYZ[1], 0, this->Resolution[1] - 1), Clamp(XYZ[2], 0, this->Resolution[2] - 1))];
 	}
 	
 	HOST_DEVICE T operator()(const Vec3f& XYZ, const bool Normalized = false) const
 	{
 		const Vec3f UVW = Normalized ? XYZ * Vec3f((float)this->Resolution[0], (float)this->Resolution[1], (float)this->Resolution[2]) : XYZ;
 
+		if (this->Layout == Enums::BrickedLayout)
+			return this->BrickedTrilinear(UVW);
+
 		const int vx = (int)floorf(UVW[0]);
 		const int vy = (int)floorf(UVW[1]);
 		const int vz = (int)floorf(UVW[2]);
@@ -236,13 +372,45 @@ public:
 		return Lerp(dz, d0, d1);
 	}
 
-	HOST_DEVICE T& operator[](const int& ID) const
+	HOST_DEVICE T BrickedTrilinear(const Vec3f& UVW) const
+	{
+		int vx = (int)floorf(UVW[0]);
+		int vy = (int)floorf(UVW[1]);
+		int vz = (int)floorf(UVW[2]);
+
+		float dx = UVW[0] - vx;
+		float dy = UVW[1] - vy;
+		float dz = UVW[2] - vz;
+
+		// Clamp once per sample, the apron holds the clamped border voxels
+		if (vx < 0 || vx >= this->Resolution[0]) { vx = Clamp(vx, 0, this->Resolution[0] - 1); dx = 0.0f; }
+		if (vy < 0 || vy >= this->Resolution[1]) { vy = Clamp(vy, 0, this->Resolution[1] - 1); dy = 0.0f; }
+		if (vz < 0 || vz >= this->Resolution[2]) { vz = Clamp(vz, 0, this->Resolution[2] - 1); dz = 0.0f; }
+
+		const int SY = BRICK_SIZE + 1;
+		const int SZ = SY * SY;
+
+		const T* pV = &this->Data[this->GetID(vx, vy, vz)];
+
+		const T d00 = Lerp(dx, pV[0], pV[1]);
+		const T d10 = Lerp(dx, pV[SY], pV[SY + 1]);
+		const T d01 = Lerp(dx, pV[SZ], pV[SZ + 1]);
+		const T d11 = Lerp(dx, pV[SZ + SY], pV[SZ + SY + 1]);
+		const T d0	= Lerp(dy, d00, d10);
+		const T d1 	= Lerp(dy, d01, d11);
+
+		return Lerp(dz, d0, d1);
+	}
+
+	HOST_DEVICE T& operator[](const long long& ID) const
 	{
-		const int ClampedID = Clamp(ID, 0, this->NoElements - 1);
+		const long long ClampedID = Clamp(ID, 0ll, this->NoElements - 1);
 		return this->Data[ClampedID];
 	}
 
-	Vec3i	Resolution;
+	Vec3i				Resolution;
+	Enums::VoxelLayout	Layout;
+	Vec3i				NoBricks;
 };
 
 }
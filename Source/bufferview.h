@@ -0,0 +1,61 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "geometry.h"
+
+namespace ExposureRender
+{
+
+// Non-owning window onto buffer memory, strides are in elements
+template<class T>
+class BufferView
+{
+public:
+	HOST_DEVICE BufferView() :
+		Data(NULL),
+		Resolution(0),
+		Strides(0)
+	{
+	}
+
+	HOST_DEVICE BufferView(T* Data, const Vec3i& Resolution, const Vec3i& Strides) :
+		Data(Data),
+		Resolution(Resolution),
+		Strides(Strides)
+	{
+	}
+
+	HOST_DEVICE long long GetNoElements() const
+	{
+		return (long long)this->Resolution[0] * this->Resolution[1] * this->Resolution[2];
+	}
+
+	HOST_DEVICE T* GetData() const
+	{
+		return this->Data;
+	}
+
+	HOST_DEVICE T& operator()(const int& X = 0, const int& Y = 0, const int& Z = 0) const
+	{
+		return this->Data[Clamp(X, 0, this->Resolution[0] - 1) * this->Strides[0] + Clamp(Y, 0, this->Resolution[1] - 1) * this->Strides[1] + (long long)Clamp(Z, 0, this->Resolution[2] - 1) * this->Strides[2]];
+	}
+
+	T*		Data;
+	Vec3i	Resolution;
+	Vec3i	Strides;
+};
+
+}
@@ -0,0 +1,244 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "boundingbox.h"
+#include "ray.h"
+#include "exception.h"
+#include "log.h"
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+class BVH
+{
+public:
+	class Node
+	{
+	public:
+		Vec3f	MinP;
+		Vec3f	MaxP;
+		int		Offset;
+		int		Count;
+		int		Axis;
+	};
+
+	HOST BVH() :
+		NoNodes(0),
+		NoItems(0),
+		Version(-1)
+	{
+	}
+
+	HOST BVH(const BVH& Other)
+	{
+		*this = Other;
+	}
+
+	HOST BVH& BVH::operator = (const BVH& Other)
+	{
+		this->NoNodes	= Other.NoNodes;
+		this->NoItems	= Other.NoItems;
+		this->Version	= Other.Version;
+
+		for (int i = 0; i < this->NoNodes; i++)
+			this->Nodes[i] = Other.Nodes[i];
+
+		for (int i = 0; i < this->NoItems; i++)
+			this->ItemIDs[i] = Other.ItemIDs[i];
+
+		return *this;
+	}
+
+	HOST void Build(const vector<BoundingBox>& Bounds)
+	{
+		// Sized for every ID a tracer can reference, dropping items would silently remove them from the render
+		if ((int)Bounds.size() > MAX_BVH_ITEMS)
+			throw(Exception(Enums::Error, "Too many items for the BVH"));
+
+		this->NoNodes	= 0;
+		this->NoItems	= (int)Bounds.size();
+
+		for (int i = 0; i < this->NoItems; i++)
+			this->ItemIDs[i] = i;
+
+		if (this->NoItems > 0)
+			this->Split(Bounds, 0, this->NoItems);
+	}
+
+	Node	Nodes[2 * MAX_BVH_ITEMS];
+	int		ItemIDs[MAX_BVH_ITEMS];
+	int		NoNodes;
+	int		NoItems;
+	int		Version;
+
+private:
+	HOST int Split(const vector<BoundingBox>& Bounds, const int& Begin, const int& End)
+	{
+		const int NodeID = this->NoNodes++;
+
+		Node& Node = this->Nodes[NodeID];
+
+		Vec3f CentroidMinP(FLT_MAX), CentroidMaxP(-FLT_MAX);
+
+		Node.MinP = Vec3f(FLT_MAX);
+		Node.MaxP = Vec3f(-FLT_MAX);
+
+		for (int i = Begin; i < End; i++)
+		{
+			const BoundingBox& Bound = Bounds[this->ItemIDs[i]];
+			const Vec3f Centroid = 0.5f * (Bound.MinP + Bound.MaxP);
+
+			Node.MinP		= Node.MinP.Min(Bound.MinP);
+			Node.MaxP		= Node.MaxP.Max(Bound.MaxP);
+			CentroidMinP	= CentroidMinP.Min(Centroid);
+			CentroidMaxP	= CentroidMaxP.Max(Centroid);
+		}
+
+		const Vec3f Extent = CentroidMaxP - CentroidMinP;
+
+		Node.Axis = Extent[0] > Extent[1] ? (Extent[0] > Extent[2] ? 0 : 2) : (Extent[1] > Extent[2] ? 1 : 2);
+
+		if (End - Begin <= 2)
+		{
+			Node.Offset	= Begin;
+			Node.Count	= End - Begin;
+			return NodeID;
+		}
+
+		const int& Axis		= Node.Axis;
+		const int Middle	= (Begin + End) / 2;
+
+		nth_element(&this->ItemIDs[Begin], &this->ItemIDs[Middle], &this->ItemIDs[0] + End, [&](const int& A, const int& B)
+		{
+			return Bounds[A].MinP[Axis] + Bounds[A].MaxP[Axis] < Bounds[B].MinP[Axis] + Bounds[B].MaxP[Axis];
+		});
+
+		this->Split(Bounds, Begin, Middle);
+
+		const int RightID = this->Split(Bounds, Middle, End);
+
+		this->Nodes[NodeID].Offset	= RightID;
+		this->Nodes[NodeID].Count	= 0;
+
+		return NodeID;
+	}
+};
+
+// Walks the nodes whose bounds overlap the ray front to back, the left child of an interior node directly follows it
+class BVHTraversal
+{
+public:
+	HOST_DEVICE BVHTraversal(const BVH& BVH, const Ray& R) :
+		pBVH(&BVH),
+		O(R.O),
+		InvD(1.0f / R.D[0], 1.0f / R.D[1], 1.0f / R.D[2]),
+		MinT(R.MinT),
+		MaxT(R.MaxT),
+		Stack(),
+		StackSize(0),
+		ItemID(0),
+		EndItemID(0)
+	{
+		if (BVH.NoNodes > 0)
+			this->Stack[this->StackSize++] = 0;
+	}
+
+	HOST_DEVICE bool Next(int& ItemID, const float& MaxT = FLT_MAX)
+	{
+		while (true)
+		{
+			if (this->ItemID < this->EndItemID)
+			{
+				ItemID = this->pBVH->ItemIDs[this->ItemID++];
+				return true;
+			}
+
+			if (this->StackSize <= 0)
+				return false;
+
+			const int NodeID		= this->Stack[--this->StackSize];
+			const BVH::Node& Node	= this->pBVH->Nodes[NodeID];
+
+			if (!this->Intersects(Node, MaxT < this->MaxT ? MaxT : this->MaxT))
+				continue;
+
+			if (Node.Count > 0)
+			{
+				this->ItemID	= Node.Offset;
+				this->EndItemID	= Node.Offset + Node.Count;
+				continue;
+			}
+
+			if (this->StackSize + 2 > MAX_BVH_STACK_SIZE)
+				continue;
+
+			if (this->InvD[Node.Axis] < 0.0f)
+			{
+				this->Stack[this->StackSize++] = NodeID + 1;
+				this->Stack[this->StackSize++] = Node.Offset;
+			}
+			else
+			{
+				this->Stack[this->StackSize++] = Node.Offset;
+				this->Stack[this->StackSize++] = NodeID + 1;
+			}
+		}
+	}
+
+private:
+	HOST_DEVICE bool Intersects(const BVH::Node& Node, const float& MaxT) const
+	{
+		float NearT = this->MinT, FarT = MaxT;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float T0 = (Node.MinP[i] - RAY_EPS - this->O[i]) * this->InvD[i];
+			float T1 = (Node.MaxP[i] + RAY_EPS - this->O[i]) * this->InvD[i];
+
+			if (T0 > T1)
+			{
+				const float Temp = T0;
+				T0 = T1;
+				T1 = Temp;
+			}
+
+			NearT	= T0 > NearT ? T0 : NearT;
+			FarT	= T1 < FarT ? T1 : FarT;
+
+			if (NearT > FarT)
+				return false;
+		}
+
+		return true;
+	}
+
+	const BVH*	pBVH;
+	Vec3f		O;
+	Vec3f		InvD;
+	float		MinT;
+	float		MaxT;
+	int			Stack[MAX_BVH_STACK_SIZE];
+	int			StackSize;
+	int			ItemID;
+	int			EndItemID;
+};
+
+}
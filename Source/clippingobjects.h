@@ -7,15 +7,213 @@
 	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
 	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
 	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
-	
+
 	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+
 #pragma once
 
 #include "clippingobject.h"
+#include "geometry.h"
 
 namespace ExposureRender
 {
 
+class ClipIntervals
+{
+public:
+	HOST_DEVICE ClipIntervals(const float& MinT = 0.0f, const float& MaxT = 0.0f) :
+		Count(0)
+	{
+		if (MinT < MaxT)
+		{
+			this->MinT[0]	= MinT;
+			this->MaxT[0]	= MaxT;
+			this->Count		= 1;
+		}
+	}
+
+	HOST_DEVICE void Intersect(const float& MinT, const float& MaxT)
+	{
+		int Count = 0;
+
+		for (int i = 0; i < this->Count; i++)
+		{
+			const float NewMinT = fmaxf(this->MinT[i], MinT);
+			const float NewMaxT = fminf(this->MaxT[i], MaxT);
+
+			if (NewMinT < NewMaxT)
+			{
+				this->MinT[Count]	= NewMinT;
+				this->MaxT[Count]	= NewMaxT;
+				Count++;
+			}
+		}
+
+		this->Count = Count;
+	}
+
+	HOST_DEVICE void Subtract(const float& MinT, const float& MaxT)
+	{
+		if (MinT >= MaxT)
+			return;
+
+		for (int i = this->Count - 1; i >= 0; i--)
+		{
+			if (MaxT <= this->MinT[i] || MinT >= this->MaxT[i])
+				continue;
+
+			const bool KeepFront	= MinT > this->MinT[i];
+			const bool KeepBack		= MaxT < this->MaxT[i];
+
+			if (KeepFront && KeepBack)
+			{
+				// Out of slots, keep the whole interval so nothing is clipped that should not be (reported by ResolveIDs on the host)
+				if (this->Count >= MAX_CLIP_INTERVALS)
+					continue;
+
+				for (int j = this->Count; j > i + 1; j--)
+				{
+					this->MinT[j] = this->MinT[j - 1];
+					this->MaxT[j] = this->MaxT[j - 1];
+				}
+
+				this->MinT[i + 1]	= MaxT;
+				this->MaxT[i + 1]	= this->MaxT[i];
+				this->MaxT[i]		= MinT;
+				this->Count++;
+			}
+			else if (KeepFront)
+			{
+				this->MaxT[i] = MinT;
+			}
+			else if (KeepBack)
+			{
+				this->MinT[i] = MaxT;
+			}
+			else
+			{
+				for (int j = i; j < this->Count - 1; j++)
+				{
+					this->MinT[j] = this->MinT[j + 1];
+					this->MaxT[j] = this->MaxT[j + 1];
+				}
+
+				this->Count--;
+			}
+		}
+	}
+
+	float	MinT[MAX_CLIP_INTERVALS];
+	float	MaxT[MAX_CLIP_INTERVALS];
+	int		Count;
+};
+
+// Span of the ray inside the clipping shape, in the parameterization of the world space ray. A plane bounds the half space in front of it, other shape types are rejected by BindClippingObject
+HOST_DEVICE bool IntersectClippingShape(const Shape& Shape, const Ray& R, float& MinT, float& MaxT)
+{
+	const Vec3f O = TransformPoint(Shape.InvTM, R.O);
+	const Vec3f D = TransformVector(Shape.InvTM, R.D);
+
+	MinT = -FLT_MAX;
+	MaxT = FLT_MAX;
+
+	switch (Shape.Type)
+	{
+		case Enums::Plane:
+		{
+			if (D[2] == 0.0f)
+				return O[2] > 0.0f;
+
+			const float T = -O[2] / D[2];
+
+			if (D[2] > 0.0f)
+				MinT = T;
+			else
+				MaxT = T;
+
+			return true;
+		}
+
+		case Enums::Box:
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				const float HalfSize = 0.5f * Shape.Size[i];
+
+				if (D[i] == 0.0f)
+				{
+					if (fabsf(O[i]) > HalfSize)
+						return false;
+
+					continue;
+				}
+
+				float T0 = (-HalfSize - O[i]) / D[i];
+				float T1 = (HalfSize - O[i]) / D[i];
+
+				if (T0 > T1)
+				{
+					const float Temp = T0;
+					T0 = T1;
+					T1 = Temp;
+				}
+
+				MinT = fmaxf(MinT, T0);
+				MaxT = fminf(MaxT, T1);
+			}
+
+			return MinT < MaxT;
+		}
+
+		case Enums::Sphere:
+		{
+			const float A = Dot(D, D);
+			const float B = 2.0f * Dot(O, D);
+			const float C = Dot(O, O) - Shape.OuterRadius * Shape.OuterRadius;
+
+			const float Discriminant = B * B - 4.0f * A * C;
+
+			if (A <= 0.0f || Discriminant <= 0.0f)
+				return false;
+
+			const float Root = sqrtf(Discriminant);
+
+			MinT = (-B - Root) / (2.0f * A);
+			MaxT = (-B + Root) / (2.0f * A);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Removes the parts of the ray inside each clipping object, or outside of it when the object is inverted
+HOST_DEVICE void ClipRay(const Ray& R, ClipIntervals& Intervals)
+{
+	for (int i = 0; i < gpTracer->ClippingObjectSlots.Count && Intervals.Count > 0; i++)
+	{
+		const ClippingObject& ClippingObject = gpClippingObjects[gpTracer->ClippingObjectSlots[i]];
+
+		float MinT = 0.0f, MaxT = 0.0f;
+
+		const bool Intersects = IntersectClippingShape(ClippingObject.Shape, R, MinT, MaxT);
+
+		if (ClippingObject.Invert)
+		{
+			if (Intersects)
+				Intervals.Intersect(MinT, MaxT);
+			else
+				Intervals.Count = 0;
+		}
+		else
+		{
+			if (Intersects)
+				Intervals.Subtract(MinT, MaxT);
+		}
+	}
+}
+
 }
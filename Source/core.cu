@@ -11,9 +11,6 @@
 	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#define __CUDA_ARCH__ 200
-
-
 #include "tracer.h"
 #include "volume.h"
 #include "light.h"
@@ -30,20 +27,60 @@ DEVICE ExposureRender::ClippingObject*	gpClippingObjects	= NULL;
 DEVICE ExposureRender::Texture*			gpTextures			= NULL;
 DEVICE ExposureRender::Bitmap*			gpBitmaps			= NULL;
 
+namespace ExposureRender
+{
+
+namespace Host
+{
+	Tracer*				gpTracer			= NULL;
+	Volume* 			gpVolumes			= NULL;
+	Light*				gpLights			= NULL;
+	Object*				gpObjects			= NULL;
+	ClippingObject*		gpClippingObjects	= NULL;
+	Texture*			gpTextures			= NULL;
+	Bitmap*				gpBitmaps			= NULL;
+}
+
+// In the host compilation pass the shared integrator code resolves the scene pointers to the host copies
+#ifndef __CUDA_ARCH__
+	using Host::gpTracer;
+	using Host::gpVolumes;
+	using Host::gpLights;
+	using Host::gpObjects;
+	using Host::gpClippingObjects;
+	using Host::gpTextures;
+	using Host::gpBitmaps;
+#endif
+
+}
+
 #include "list.cuh"
+#include "threadpool.h"
+#include "tilescheduler.h"
+#include "timingregistry.h"
+
+ExposureRender::Cuda::List<ExposureRender::Tracer, ExposureRender::ErTracer>					gTracers("gpTracer", &ExposureRender::Host::gpTracer);
+ExposureRender::Cuda::List<ExposureRender::Volume, ExposureRender::ErVolume>					gVolumes("gpVolumes", &ExposureRender::Host::gpVolumes);
+ExposureRender::Cuda::List<ExposureRender::Light, ExposureRender::ErLight>						gLights("gpLights", &ExposureRender::Host::gpLights);
+ExposureRender::Cuda::List<ExposureRender::Object, ExposureRender::ErObject>					gObjects("gpObjects", &ExposureRender::Host::gpObjects);
+ExposureRender::Cuda::List<ExposureRender::ClippingObject, ExposureRender::ErClippingObject>	gClippingObjects("gpClippingObjects", &ExposureRender::Host::gpClippingObjects);
+ExposureRender::Cuda::List<ExposureRender::Texture, ExposureRender::ErTexture>					gTextures("gpTextures", &ExposureRender::Host::gpTextures);
+ExposureRender::Cuda::List<ExposureRender::Bitmap, ExposureRender::ErBitmap>					gBitmaps("gpBitmaps", &ExposureRender::Host::gpBitmaps);
 
-ExposureRender::Cuda::List<ExposureRender::Tracer, ExposureRender::ErTracer>					gTracers("gpTracer");
-ExposureRender::Cuda::List<ExposureRender::Volume, ExposureRender::ErVolume>					gVolumes("gpVolumes");
-ExposureRender::Cuda::List<ExposureRender::Light, ExposureRender::ErLight>						gLights("gpLights");
-ExposureRender::Cuda::List<ExposureRender::Object, ExposureRender::ErObject>					gObjects("gpObjects");
-ExposureRender::Cuda::List<ExposureRender::ClippingObject, ExposureRender::ErClippingObject>	gClippingObjects("gpClippingObjects");
-ExposureRender::Cuda::List<ExposureRender::Texture, ExposureRender::ErTexture>					gTextures("gpTextures");
-ExposureRender::Cuda::List<ExposureRender::Bitmap, ExposureRender::ErBitmap>					gBitmaps("gpBitmaps");
+ExposureRender::Host::ThreadPool		gThreadPool;
+ExposureRender::Host::TileScheduler		gTileScheduler;
+
+map<int, ExposureRender::Host::TimingRegistry>	gTimings;
+mutex											gTimingsMutex;
+ExposureRender::Host::TimingRegistry*			gpTimings = NULL;
+
+int gTextureSlotsVersion = -1;
 
 #include "singlescattering.cuh"
+#include "pathtracing.cuh"
 #include "filterframeestimate.cuh"
-#include "estimate.cuh"
 #include "toneMap.cuh"
+#include "estimatetonemap.cuh"
 
 namespace ExposureRender
 {
@@ -53,9 +90,18 @@ EXPOSURE_RENDER_DLL void BindTracer(const ErTracer& Tracer, const bool& Bind /*=
 	DebugLog("%s, Bind = %s", __FUNCTION__, Bind ? "true" : "false");
 	
 	if (Bind)
+	{
 		gTracers.Bind(Tracer);
+	}
 	else
+	{
 		gTracers.Unbind(Tracer);
+
+		lock_guard<mutex> Lock(gTimingsMutex);
+
+		gTimings.erase(Tracer.ID);
+		gpTimings = NULL;
+	}
 }
 
 EXPOSURE_RENDER_DLL void BindVolume(const ErVolume& Volume, const bool& Bind /*= true*/)
@@ -68,6 +114,13 @@ EXPOSURE_RENDER_DLL void BindVolume(const ErVolume& Volume, const bool& Bind /*=
 		gVolumes.Unbind(Volume);
 }
 
+EXPOSURE_RENDER_DLL void BindVolume(ErVolume&& Volume)
+{
+	DebugLog(__FUNCTION__);
+
+	gVolumes.Bind(move(Volume));
+}
+
 EXPOSURE_RENDER_DLL void BindLight(const ErLight& Light, const bool& Bind /*= true*/)
 {
 	DebugLog("%s, Bind = %s", __FUNCTION__, Bind ? "true" : "false");
@@ -93,7 +146,26 @@ EXPOSURE_RENDER_DLL void BindClippingObject(const ErClippingObject& ClippingObje
 	DebugLog("%s, Bind = %s", __FUNCTION__, Bind ? "true" : "false");
 	
 	if (Bind)
+	{
+		switch (ClippingObject.Shape.Type)
+		{
+			case Enums::Plane:
+			case Enums::Box:
+			case Enums::Sphere:
+				break;
+
+			default:
+			{
+				char Message[MAX_CHAR_SIZE];
+
+				sprintf_s(Message, MAX_CHAR_SIZE, "%s failed, clipping object with ID:%d has an unsupported shape type (%d), only planes, boxes and spheres can clip", __FUNCTION__, ClippingObject.ID, (int)ClippingObject.Shape.Type);
+
+				throw(Exception(Enums::Error, Message));
+			}
+		}
+
 		gClippingObjects.Bind(ClippingObject);
+	}
 	else
 		gClippingObjects.Unbind(ClippingObject);
 }
@@ -118,23 +190,223 @@ EXPOSURE_RENDER_DLL void BindBitmap(const ErBitmap& Bitmap, const bool& Bind /*=
 		gBitmaps.Unbind(Bitmap);
 }
 
+// List versions only grow, so their sum changes whenever one of the lists changed
+HOST void ResolveTextureIDs()
+{
+	if (gTextureSlotsVersion == gLights.Version + gObjects.Version + gTextures.Version + gBitmaps.Version)
+		return;
+
+	for (size_t i = 0; i < gLights.Items.size(); i++)
+		gLights.Items[i]->TextureSlot = gTextures.Index[gLights.Items[i]->TextureID];
+
+	for (size_t i = 0; i < gObjects.Items.size(); i++)
+	{
+		Object& Object = *gObjects.Items[i];
+
+		Object.DiffuseTextureSlot		= gTextures.Index[Object.DiffuseTextureID];
+		Object.SpecularTextureSlot		= gTextures.Index[Object.SpecularTextureID];
+		Object.GlossinessTextureSlot	= gTextures.Index[Object.GlossinessTextureID];
+	}
+
+	for (size_t i = 0; i < gTextures.Items.size(); i++)
+		gTextures.Items[i]->BitmapSlot = gBitmaps.Index[gTextures.Items[i]->BitmapID];
+
+	gLights.Synchronize();
+	gObjects.Synchronize();
+	gTextures.Synchronize();
+
+	gTextureSlotsVersion = gLights.Version + gObjects.Version + gTextures.Version + gBitmaps.Version;
+}
+
+HOST void ResolveIDs(Tracer& Tracer)
+{
+	const int Version = gVolumes.Version + gLights.Version + gObjects.Version + gClippingObjects.Version;
+
+	if (Tracer.SlotsVersion == Version)
+		return;
+
+	Tracer.ResolveIDs(gVolumes.Index, gLights.Index, gObjects.Index, gClippingObjects.Index);
+	Tracer.SlotsVersion = Version;
+
+	if (Tracer.VolumeSlot < 0)
+	{
+		char Message[MAX_CHAR_SIZE];
+
+		sprintf_s(Message, MAX_CHAR_SIZE, "%s failed, volume with ID:%d is not bound", __FUNCTION__, Tracer.VolumeID);
+
+		throw(Exception(Enums::Error, Message));
+	}
+
+	// Every non-inverted clipping object can split one interval in two, beyond the available slots a span is left unclipped
+	int NoSplits = 0;
+
+	for (int i = 0; i < Tracer.ClippingObjectSlots.Count; i++)
+		if (!gClippingObjects.Items[Tracer.ClippingObjectSlots[i]]->Invert)
+			NoSplits++;
+
+	if (1 + NoSplits > MAX_CLIP_INTERVALS)
+		DebugLog("%s: %d clipping objects may need more than %d clip intervals, overflowing spans are left unclipped", __FUNCTION__, NoSplits, MAX_CLIP_INTERVALS);
+}
+
+HOST void UpdateBVHs(Tracer& Tracer)
+{
+	if (Tracer.LightBVH.Version != gLights.Version)
+	{
+		vector<BoundingBox> Bounds;
+
+		for (int i = 0; i < Tracer.LightSlots.Count; i++)
+			Bounds.push_back(GetBoundingBox(gLights.HostList[Tracer.LightSlots[i]].Shape));
+
+		Tracer.LightBVH.Build(Bounds);
+		Tracer.LightBVH.Version = gLights.Version;
+	}
+
+	if (Tracer.ObjectBVH.Version != gObjects.Version)
+	{
+		vector<BoundingBox> Bounds;
+
+		for (int i = 0; i < Tracer.ObjectSlots.Count; i++)
+			Bounds.push_back(GetBoundingBox(gObjects.HostList[Tracer.ObjectSlots[i]].Shape));
+
+		Tracer.ObjectBVH.Build(Bounds);
+		Tracer.ObjectBVH.Version = gObjects.Version;
+	}
+}
+
+HOST void UpdateLightSelection(Tracer& Tracer)
+{
+	if (Tracer.LightSelection.Version == gLights.Version)
+		return;
+
+	vector<float> Weights;
+
+	for (int i = 0; i < Tracer.LightSlots.Count; i++)
+	{
+		const Light& Light = gLights.HostList[Tracer.LightSlots[i]];
+
+		Weights.push_back(Light.Unit == Enums::Lux ? Light.Multiplier : Light.Multiplier * Light.Shape.Area);
+	}
+
+	Tracer.LightSelection.Build(Weights);
+	Tracer.LightSelection.Version = gLights.Version;
+}
+
+// Registries are only created for bound tracers, map nodes stay put so the returned registry remains valid until the tracer is unbound
+HOST Host::TimingRegistry* FindTimings(const int& TracerID, const bool& Create)
+{
+	lock_guard<mutex> Lock(gTimingsMutex);
+
+	map<int, Host::TimingRegistry>::iterator It = gTimings.find(TracerID);
+
+	if (It != gTimings.end())
+		return &It->second;
+
+	return Create && gTracers.Exists(TracerID) ? &gTimings[TracerID] : NULL;
+}
+
 EXPOSURE_RENDER_DLL void RenderEstimate(int TracerID)
 {
-	gTracers.Synchronize(TracerID);
+	gpTimings = FindTimings(TracerID, true);
+
+	Host::ScopedTiming Timing(gpTimings, "Render estimate");
+
+	ResolveTextureIDs();
+	ResolveIDs(gTracers[TracerID]);
+
+	{
+		Host::ScopedTiming Timing(gpTimings, "Update BVHs");
+		UpdateBVHs(gTracers[TracerID]);
+	}
+
+	{
+		Host::ScopedTiming Timing(gpTimings, "Update light selection");
+		UpdateLightSelection(gTracers[TracerID]);
+	}
+
+	{
+		Host::ScopedTiming Timing(gpTimings, "Synchronize tracer");
+		gTracers.Synchronize(TracerID);
+	}
 
-	SingleScattering(gTracers[TracerID]);
-	FilterFrameEstimate(gTracers[TracerID]);
-	ComputeEstimate(gTracers[TracerID]);
-	ToneMap(gTracers[TracerID]);
+	Tracer& Tracer = gTracers[TracerID];
 
-	gTracers[TracerID].NoIterations++;
+	switch (Tracer.Backend)
+	{
+		case Enums::CudaBackend:
+		{
+			const Volume* pVolume = gVolumes.Find(Tracer.VolumeID);
+
+			if (pVolume != NULL && pVolume->IsStreamed())
+				throw(Exception(Enums::Error, "Streamed volumes can only be rendered by the host backend"));
+
+			if (Tracer.RenderSettings.Integrator.Type == Enums::PathTracingIntegrator)
+				PathTracing(Tracer);
+			else
+				SingleScattering(Tracer);
+
+			FilterFrameEstimate(Tracer);
+			ComputeEstimateToneMap(Tracer);
+			break;
+		}
+
+		case Enums::HostBackend:
+		{
+			gThreadPool.Resize(Tracer.RenderSettings.Threading.NoThreads);
+
+			if (Tracer.RenderSettings.Integrator.Type == Enums::PathTracingIntegrator)
+				Host::PathTracing(Tracer);
+			else
+				Host::SingleScattering(Tracer);
+
+			Host::FilterFrameEstimate(Tracer);
+			Host::ComputeEstimateToneMap(Tracer);
+			break;
+		}
+	}
+
+	Tracer.NoIterations++;
 }
 
 EXPOSURE_RENDER_DLL void GetEstimate(int TracerID, unsigned char* pData)
 {
+	Host::ScopedTiming Timing(FindTimings(TracerID, false), "Get estimate");
+
 	FrameBuffer& FB = gTracers[TracerID].FrameBuffer;
 
-	Cuda::MemCopyDeviceToHost(FB.DisplayEstimate.GetData(), (ColorRGBAuc*)pData, FB.DisplayEstimate.GetNoElements());
+	if (FB.DisplayEstimate.MemoryType == Enums::Host)
+		memcpy(pData, FB.DisplayEstimate.GetData(), FB.DisplayEstimate.GetNoBytes());
+	else
+		Cuda::MemCopyDeviceToHost(FB.DisplayEstimate.GetData(), (ColorRGBAuc*)pData, FB.DisplayEstimate.GetNoElements());
+}
+
+EXPOSURE_RENDER_DLL void GetTileTimings(int TracerID, int& NoTilesX, int& NoTilesY, float* pTileTimings)
+{
+	const Buffer2D<float>& TileTimings = gTracers[TracerID].FrameBuffer.TileTimings;
+
+	NoTilesX = TileTimings.Resolution[0];
+	NoTilesY = TileTimings.Resolution[1];
+
+	if (pTileTimings != NULL && TileTimings.GetNoElements() > 0)
+		memcpy(pTileTimings, TileTimings.GetData(), TileTimings.GetNoBytes());
+}
+
+EXPOSURE_RENDER_DLL void GetTimings(int TracerID, int& NoTimings, KernelTiming* pTimings)
+{
+	lock_guard<mutex> Lock(gTimingsMutex);
+
+	map<int, Host::TimingRegistry>::iterator It = gTimings.find(TracerID);
+
+	if (It == gTimings.end())
+		NoTimings = 0;
+	else if (pTimings == NULL)
+		NoTimings = It->second.GetNoTimings();
+	else
+		NoTimings = It->second.GetTimings(pTimings, NoTimings);
+}
+
+EXPOSURE_RENDER_DLL void GetMemoryPoolStatistics(const Enums::MemoryType& MemoryType, MemoryPoolStatistics& Statistics)
+{
+	Statistics = MemoryPool::Get().GetStatistics(MemoryType);
 }
 
 EXPOSURE_RENDER_DLL void GetAutoFocusDistance(int TracerID, int FilmU, int FilmV, float& AutoFocusDistance)
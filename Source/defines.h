@@ -13,7 +13,7 @@
 
 #pragma once
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 	#include <host_defines.h>
 #endif
 
@@ -32,7 +32,7 @@ using namespace std;
 namespace ExposureRender
 {
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 	#define KERNEL						__global__
 	#define HOST						__host__
 	#define DEVICE						__device__
@@ -40,6 +40,7 @@ namespace ExposureRender
 	#define HOST_DEVICE					HOST DEVICE 
 	#define HOST_DEVICE_NI				HOST_DEVICE __noinline__
 	#define CD							__device__ __constant__
+	#define ALIGN(N)					__align__(N)
 #else
 	#define KERNEL
 	#define HOST
@@ -48,6 +49,7 @@ namespace ExposureRender
 	#define HOST_DEVICE
 	#define HOST_DEVICE_NI
 	#define CD
+	#define ALIGN(N)					__declspec(align(N))
 #endif
 
 #define PI_F						3.141592654f	
@@ -57,7 +59,7 @@ namespace ExposureRender
 #define INV_PI_F					0.31830988618379067154f
 #define INV_TWO_PI_F				0.15915494309189533577f
 #define FOUR_PI_F					4.0f * PI_F
-#define INV_FOUR_PI_F				1.0f / FOUR_PI_F
+#define INV_FOUR_PI_F				0.07957747154594766788f
 #define	EULER_F						2.718281828f
 #define RAD_F						57.29577951308232f
 #define TWO_RAD_F					2.0f * RAD_F
@@ -69,7 +71,17 @@ namespace ExposureRender
 #define ONE_OVER_255				1.0f / 255.0f
 #define	MAX_CHAR_SIZE				256
 #define MAX_NO_TF_NODES				128
+#define MAX_TF_LUT_SIZE				1024
+#define MAX_TF_LUT_LEVELS			10
+#define MAX_NO_INDICES				256
+#define MAX_BVH_ITEMS				MAX_NO_INDICES
+#define MAX_BVH_STACK_SIZE			32
+#define MAX_CLIP_INTERVALS			8
+#define MAX_ALIAS_TABLE_SIZE		MAX_NO_INDICES
+#define MAX_TIMING_SAMPLES			128
 #define NO_COLOR_COMPONENTS			4
+#define MACRO_CELL_SIZE				8
+#define BRICK_SIZE					8
 
 	/*
 
@@ -24,6 +24,18 @@ namespace Enums
 		Device
 	};
 
+	enum Backend
+	{
+		CudaBackend = 0,
+		HostBackend
+	};
+
+	enum VoxelLayout
+	{
+		LinearLayout = 0,
+		BrickedLayout
+	};
+
 	enum MemoryUnit
 	{
 		KiloByte,
@@ -65,6 +77,31 @@ namespace Enums
 		GradientMagnitude
 	};
 
+	enum TraversalMode
+	{
+		FixedStep = 0,
+		DeltaTracking
+	};
+
+	enum SamplerType
+	{
+		Random = 0,
+		Sobol
+	};
+
+	enum Integrator
+	{
+		SingleScatteringIntegrator = 0,
+		PathTracingIntegrator
+	};
+
+	enum LightingStrategy
+	{
+		LightSampling = 0,
+		BsdfSampling,
+		MultipleImportanceSampling
+	};
+
 	enum GradientMode
 	{
 		ForwardDifferences = 0,
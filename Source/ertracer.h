@@ -18,10 +18,6 @@
 #include "camera.h"
 #include "rendersettings.h"
 
-#include <map>
-
-using namespace std;
-
 namespace ExposureRender
 {
 
@@ -37,6 +33,7 @@ public:
 		Emission1D(),
 		Camera(),
 		RenderSettings(),
+		Backend(Enums::CudaBackend),
 		NoIterations(0),
 		VolumeID(0),
 		LightIDs(),
@@ -65,6 +62,7 @@ public:
 		this->Emission1D			= Other.Emission1D;
 		this->Camera				= Other.Camera;
 		this->RenderSettings		= Other.RenderSettings;
+		this->Backend				= Other.Backend;
 		this->NoIterations			= Other.NoIterations;
 		this->VolumeID				= Other.VolumeID;
 		this->LightIDs				= Other.LightIDs;
@@ -74,29 +72,6 @@ public:
 		return *this;
 	}
 	
-	HOST void BindIDs(Indices SourceIDs, Indices& TargetIDs, map<int, int> HashMap)
-	{
-		for (int i = 0; i < SourceIDs.Count; i++)
-			TargetIDs[i] = HashMap[SourceIDs[i]];
-
-		TargetIDs.Count = SourceIDs.Count;
-	}
-
-	HOST void BindLightIDs(Indices LightIDs, map<int, int> HashMap)
-	{
-		BindIDs(LightIDs, this->LightIDs, HashMap);
-	}
-
-	HOST void BindObjectIDs(Indices ObjectIDs, map<int, int> HashMap)
-	{
-		BindIDs(ObjectIDs, this->ObjectIDs, HashMap);
-	}
-
-	HOST void BindClippingObjectIDs(Indices ClippingObjectIDs, map<int, int> HashMap)
-	{
-		BindIDs(ClippingObjectIDs, this->ClippingObjectIDs, HashMap);
-	}
-
 	ScalarTransferFunction1D	Opacity1D;
 	ColorTransferFunction1D		Diffuse1D;
 	ColorTransferFunction1D		Specular1D;
@@ -104,6 +79,7 @@ public:
 	ColorTransferFunction1D		Emission1D;
 	Camera						Camera;
 	RenderSettings				RenderSettings;
+	Enums::Backend				Backend;
 	int							NoIterations;
 	int							VolumeID;
 	Indices						LightIDs;
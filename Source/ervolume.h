@@ -16,6 +16,10 @@
 #include "erbindable.h"
 #include "vector.h"
 #include "buffer3d.h"
+#include "mappedfile.h"
+#include "brickcache.h"
+
+#include <memory>
 
 namespace ExposureRender
 {
@@ -27,7 +31,11 @@ public:
 		ErBindable(),
 		Voxels(Enums::Host, "Host Voxels"),
 		NormalizeSize(false),
-		Spacing(1.0f)
+		Spacing(1.0f),
+		Layout(Enums::LinearLayout),
+		PrecomputeGradients(false),
+		File(),
+		BrickCache()
 	{
 	}
 
@@ -39,7 +47,11 @@ public:
 		ErBindable(),
 		Voxels(Enums::Host, "Host Voxels"),
 		NormalizeSize(false),
-		Spacing(1.0f)
+		Spacing(1.0f),
+		Layout(Enums::LinearLayout),
+		PrecomputeGradients(false),
+		File(),
+		BrickCache()
 	{
 		*this = Other;
 	}
@@ -48,24 +60,82 @@ public:
 	{
 		ErBindable::operator=(Other);
 
-		this->Voxels		= Other.Voxels;
-		this->NormalizeSize	= Other.NormalizeSize;
-		this->Spacing		= Other.Spacing;
+		this->Voxels				= Other.Voxels;
+		this->NormalizeSize			= Other.NormalizeSize;
+		this->Spacing				= Other.Spacing;
+		this->Layout				= Other.Layout;
+		this->PrecomputeGradients	= Other.PrecomputeGradients;
+		this->File					= Other.File;
+		this->BrickCache			= Other.BrickCache;
 
 		return *this;
 	}
 
-	HOST void BindVoxels(const Vec3i& Resolution, const Vec3f& Spacing, unsigned short* Voxels, const bool& NormalizeSize = false)
+	HOST void BindVoxels(const Vec3i& Resolution, const Vec3f& Spacing, unsigned short* Voxels, const bool& NormalizeSize = false, const Enums::VoxelLayout& Layout = Enums::LinearLayout)
 	{
 		this->Voxels.Set(Enums::Host, Resolution, Voxels);
+		this->File.reset();
+		this->BrickCache.reset();
+
+		this->NormalizeSize	= NormalizeSize;
+		this->Spacing		= Spacing;
+		this->Layout		= Layout;
+	}
+
+	// Binds without copying, the caller keeps the voxels valid and unchanged until the volume is rebound or unbound
+	HOST void WrapVoxels(const Vec3i& Resolution, const Vec3f& Spacing, unsigned short* Voxels, const bool& NormalizeSize = false, const Enums::VoxelLayout& Layout = Enums::LinearLayout)
+	{
+		this->Voxels.Wrap(Resolution, Voxels);
+		this->File.reset();
+		this->BrickCache.reset();
+
+		this->NormalizeSize	= NormalizeSize;
+		this->Spacing		= Spacing;
+		this->Layout		= Layout;
+	}
+
+	// Binds raw voxels straight from a read-only mapping of the file, which stays open while this volume or its bound copy uses it
+	HOST void MapVoxels(const Vec3i& Resolution, const Vec3f& Spacing, const char* pFileName, const long long& Offset = 0, const bool& NormalizeSize = false, const Enums::VoxelLayout& Layout = Enums::LinearLayout)
+	{
+		shared_ptr<Host::MappedFile> File(new Host::MappedFile(pFileName));
+
+		const long long NoBytes = (long long)Resolution[0] * Resolution[1] * Resolution[2] * sizeof(unsigned short);
+
+		if (Offset < 0 || Offset % sizeof(unsigned short) != 0 || Offset + NoBytes > File->GetNoBytes())
+			throw(Exception(Enums::Error, "The voxels do not fit in the mapped file"));
+
+		this->WrapVoxels(Resolution, Spacing, (unsigned short*)((const char*)File->GetData() + Offset), NormalizeSize, Layout);
+
+		this->File = File;
+	}
 
+	// Samples the volume from a file written by CreateBrickFile, loading bricks on demand and keeping at most CacheSize bytes of them in memory.
+	// Only the host backend can render a streamed volume, and gradients are never precomputed for it
+	HOST void StreamVoxels(const char* pFileName, const Vec3f& Spacing, const long long& CacheSize, const bool& NormalizeSize = false)
+	{
+		shared_ptr<Host::BrickCache> BrickCache(new Host::BrickCache(pFileName, CacheSize));
+
+		this->Voxels.Free();
+		this->File.reset();
+
+		this->BrickCache	= BrickCache;
 		this->NormalizeSize	= NormalizeSize;
 		this->Spacing		= Spacing;
+		this->Layout		= Enums::LinearLayout;
+	}
+
+	HOST static void CreateBrickFile(const char* pRawFileName, const Vec3i& Resolution, const char* pBrickFileName, const long long& Offset = 0)
+	{
+		Host::BrickCache::CreateBrickFile(pRawFileName, Offset, Resolution, pBrickFileName);
 	}
 
-	Buffer3D<unsigned short>	Voxels;
-	bool						NormalizeSize;
-	Vec3f						Spacing;
+	Buffer3D<unsigned short>			Voxels;
+	bool								NormalizeSize;
+	Vec3f								Spacing;
+	Enums::VoxelLayout					Layout;
+	bool								PrecomputeGradients;
+	shared_ptr<Host::MappedFile>		File;
+	shared_ptr<Host::BrickCache>		BrickCache;
 };
 
 }
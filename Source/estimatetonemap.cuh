@@ -0,0 +1,83 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "utilities.h"
+#include "tonemap.cuh"
+
+namespace ExposureRender
+{
+
+HOST_DEVICE void ComputeEstimateToneMap(const int& X, const int& Y)
+{
+	FrameBuffer& FrameBuffer = gpTracer->FrameBuffer;
+
+	int NoSamples		= FrameBuffer.NoSamples(X, Y);
+	ColorXYZAf Mean		= FrameBuffer.RunningEstimateXyza(X, Y);
+	Vec4f Statistics	= FrameBuffer.RunningStatistics(X, Y);
+
+	if (gpTracer->NoIterations == 0)
+		NoSamples = 0;
+
+	if (!Converged(Statistics, NoSamples))
+	{
+		// The displayed estimate averages the filtered frames, the convergence statistics the unfiltered samples
+		const ColorXYZAf& Sample = FrameBuffer.FrameEstimate(X, Y);
+
+		NoSamples++;
+
+		Mean		= CumulativeMovingAverage(Mean, FrameBuffer.FilteredFrameEstimate(X, Y), NoSamples);
+		Statistics	= CumulativeMovingAverage(Statistics, Vec4f(Sample[1], Sample[1] * Sample[1], Sample[3], Sample[3] * Sample[3]), NoSamples);
+
+		FrameBuffer.NoSamples(X, Y)				= NoSamples;
+		FrameBuffer.RunningEstimateXyza(X, Y)	= Mean;
+		FrameBuffer.RunningStatistics(X, Y)		= Statistics;
+	}
+
+	const ColorRGBuc RGB = ToneMap(Mean);
+
+	FrameBuffer.DisplayEstimate(X, Y) = ColorRGBAuc(RGB[0], RGB[1], RGB[2], (unsigned char)(Mean[3] * 255.0f));
+}
+
+KERNEL void KrnlComputeEstimateToneMap()
+{
+	KERNEL_2D(gpTracer->FrameBuffer.Resolution[0], gpTracer->FrameBuffer.Resolution[1])
+
+	ComputeEstimateToneMap(IDx, IDy);
+}
+
+void ComputeEstimateToneMap(Tracer& Tracer)
+{
+	LAUNCH_DIMENSIONS(Tracer.FrameBuffer.Resolution[0], Tracer.FrameBuffer.Resolution[1], 1, 16, 8, 1)
+	LAUNCH_CUDA_KERNEL_TIMED((KrnlComputeEstimateToneMap<<<GridDim, BlockDim>>>()), "Compute running estimate and tone map");
+}
+
+namespace Host
+{
+
+void ComputeEstimateToneMap(Tracer& Tracer)
+{
+	ScopedTiming Timing(gpTimings, "Compute running estimate and tone map");
+
+	gThreadPool.ParallelFor(Tracer.FrameBuffer.Resolution[1], [&](const int& Y)
+	{
+		for (int X = 0; X < Tracer.FrameBuffer.Resolution[0]; X++)
+			ExposureRender::ComputeEstimateToneMap(X, Y);
+	});
+}
+
+}
+
+}
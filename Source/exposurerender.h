@@ -20,12 +20,15 @@
 #include "erclippingobject.h"
 #include "ertexture.h"
 #include "erbitmap.h"
+#include "timing.h"
+#include "memorypool.h"
 
 namespace ExposureRender
 {
 
 EXPOSURE_RENDER_DLL void BindTracer(const ErTracer& Tracer, const bool& Bind = true);
 EXPOSURE_RENDER_DLL void BindVolume(const ErVolume& Volume, const bool& Bind = true);
+EXPOSURE_RENDER_DLL void BindVolume(ErVolume&& Volume);		// Takes over the voxels instead of copying them, Volume.Voxels is empty afterwards
 EXPOSURE_RENDER_DLL void BindLight(const ErLight& Light, const bool& Bind = true);
 EXPOSURE_RENDER_DLL void BindObject(const ErObject& Object, const bool& Bind = true);
 EXPOSURE_RENDER_DLL void BindClippingObject(const ErClippingObject& ClippingObject, const bool& Bind = true);
@@ -33,6 +36,9 @@ EXPOSURE_RENDER_DLL void BindTexture(const ErTexture& Texture, const bool& Bind
 EXPOSURE_RENDER_DLL void BindBitmap(const ErBitmap& Bitmap, const bool& Bind = true);
 EXPOSURE_RENDER_DLL void RenderEstimate(int TracerID);
 EXPOSURE_RENDER_DLL void GetEstimate(int TracerID, unsigned char* pData);
+EXPOSURE_RENDER_DLL void GetTileTimings(int TracerID, int& NoTilesX, int& NoTilesY, float* pTileTimings = NULL);
+EXPOSURE_RENDER_DLL void GetTimings(int TracerID, int& NoTimings, KernelTiming* pTimings = NULL);
+EXPOSURE_RENDER_DLL void GetMemoryPoolStatistics(const Enums::MemoryType& MemoryType, MemoryPoolStatistics& Statistics);
 EXPOSURE_RENDER_DLL void GetAutoFocusDistance(int TracerID, int FilmU, int FilmV, float& AutoFocusDistance);
 EXPOSURE_RENDER_DLL void GetNoIterations(int TracerID, int& NoIterations);
 
@@ -13,6 +13,10 @@
 
 #pragma once
 
+#include "defines.h"
+
+#include <math.h>
+
 namespace ExposureRender
 {
 
@@ -22,8 +26,22 @@ namespace ExposureRender
 class GaussianFilter
 {
 public:
+	HOST GaussianFilter() :
+		KernelRadius(0)
+	{
+		this->KernelD[0] = 1.0f;
+	}
+
+	HOST void Build(const int& KernelRadius, const float& Sigma)
+	{
+		this->KernelRadius = KernelRadius < 0 ? 0 : (KernelRadius > (MAX_GAUSSIAN_FILTER_KERNEL_SIZE - 1) / 2 ? (MAX_GAUSSIAN_FILTER_KERNEL_SIZE - 1) / 2 : KernelRadius);
+
+		for (int i = -this->KernelRadius; i <= this->KernelRadius; i++)
+			this->KernelD[this->KernelRadius + i] = expf(-(float)(i * i) / (2.0f * Sigma * Sigma));
+	}
+
 	int		KernelRadius;
-	float	KernelD[MAX_BILATERAL_FILTER_KERNEL_SIZE];
+	float	KernelD[MAX_GAUSSIAN_FILTER_KERNEL_SIZE];
 };
 
 class BilateralFilter
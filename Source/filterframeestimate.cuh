@@ -17,55 +17,136 @@
 #include "filter.h"
 #include "tracer.h"
 
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
 namespace ExposureRender
 {
 
-HOST_DEVICE_NI float Gauss2D(const float& Sigma, const int& X, const int& Y)
+HOST_DEVICE_NI void FilterFrameEstimate(const int& X, const int& Y, const Vec2i& Direction, const GaussianFilter& Filter, const BufferView<ColorXYZAf>& Input, const BufferView<ColorXYZAf>& Output)
+{
+	const int Coordinate	= Direction[0] * X + Direction[1] * Y;
+	const int Size			= Direction[0] * Input.Resolution[0] + Direction[1] * Input.Resolution[1];
+
+	const int Range[2] = { max(-Filter.KernelRadius, -Coordinate), min(Filter.KernelRadius, Size - 1 - Coordinate) };
+
+	ColorXYZAf Sum		= ColorXYZAf::Black();
+	float TotalWeight	= 0.0f;
+
+	for (int i = Range[0]; i <= Range[1]; i++)
+	{
+		const float& Weight = Filter.KernelD[Filter.KernelRadius + i];
+
+		Sum			+= Input(X + i * Direction[0], Y + i * Direction[1]) * Weight;
+		TotalWeight	+= Weight;
+	}
+
+	if (TotalWeight > 0.0f)
+		Sum /= TotalWeight;
+
+	Sum[3] = Input(X, Y)[3];
+
+	Output(X, Y) = Sum;
+}
+
+KERNEL void KrnlFilterFrameEstimateHorizontal()
 {
-	return expf(-((X * X + Y * Y) / (2 * Sigma * Sigma)));
+	KERNEL_2D(gpTracer->FrameBuffer.Resolution[0], gpTracer->FrameBuffer.Resolution[1])
+
+	FilterFrameEstimate(IDx, IDy, Vec2i(1, 0), gpTracer->FrameFilter, gpTracer->FrameBuffer.FrameEstimate.GetView(), gpTracer->FrameBuffer.FrameEstimateTemp.GetView());
 }
 
-KERNEL void KrnlFilterFrameEstimate(int KernelRadius, float Sigma)
+KERNEL void KrnlFilterFrameEstimateVertical()
 {
 	KERNEL_2D(gpTracer->FrameBuffer.Resolution[0], gpTracer->FrameBuffer.Resolution[1])
 
-	int Range[2][2];
+	FilterFrameEstimate(IDx, IDy, Vec2i(0, 1), gpTracer->FrameFilter, gpTracer->FrameBuffer.FrameEstimateTemp.GetView(), gpTracer->FrameBuffer.FilteredFrameEstimate.GetView());
+}
+
+void FilterFrameEstimate(Tracer& Tracer)
+{
+	LAUNCH_DIMENSIONS(Tracer.FrameBuffer.Resolution[0], Tracer.FrameBuffer.Resolution[1], 1, 8, 8, 1)
+	LAUNCH_CUDA_KERNEL_TIMED((KrnlFilterFrameEstimateHorizontal<<<GridDim, BlockDim>>>()), "Gaussian filter (Horizontal)");
+	LAUNCH_CUDA_KERNEL_TIMED((KrnlFilterFrameEstimateVertical<<<GridDim, BlockDim>>>()), "Gaussian filter (Vertical)");
+}
 
-	Range[0][0] = max((int)ceilf(IDx - KernelRadius), 0);
-	Range[0][1] = min((int)floorf(IDx + KernelRadius), gpTracer->FrameBuffer.Resolution[0] - 1);
-	Range[1][0] = max((int)ceilf(IDy - KernelRadius), 0);
-	Range[1][1] = min((int)floorf(IDy + KernelRadius), gpTracer->FrameBuffer.Resolution[1] - 1);
+namespace Host
+{
 
-	ColorXYZAf Sum		= ColorXYZAf::Black();
-	float Weight		= 0.0f;
-	float TotalWeight	= 0.0f;
+HOST void FilterFrameEstimate(const int& Y, const Vec2i& Direction, const GaussianFilter& Filter, const BufferView<ColorXYZAf>& Input, const BufferView<ColorXYZAf>& Output)
+{
+	const Vec3i& Resolution = Input.Resolution;
 
-	for (int y = Range[1][0]; y <= Range[1][1]; y++)
+	// Pixels whose footprint lies entirely inside the frame share the same normalization
+	int Interior[2] = { 0, 0 };
+
+	if (Direction[0] == 1)
 	{
-		for (int x = Range[0][0]; x <= Range[0][1]; x++)
-		{
-			Weight		= Gauss2D(Sigma, x - IDx, y - IDy);
-			Sum			+= gpTracer->FrameBuffer.FrameEstimate(x, y) * Weight;
-			TotalWeight	+= Weight;
-		}
+		Interior[0] = min(Filter.KernelRadius, Resolution[0]);
+		Interior[1] = max(Resolution[0] - Filter.KernelRadius, Interior[0]);
+	}
+	else if (Y >= Filter.KernelRadius && Y < Resolution[1] - Filter.KernelRadius)
+	{
+		Interior[1] = Resolution[0];
 	}
 
-	Sum[3] = gpTracer->FrameBuffer.FrameEstimate(IDx, IDy)[3];
+	for (int X = 0; X < Interior[0]; X++)
+		ExposureRender::FilterFrameEstimate(X, Y, Direction, Filter, Input, Output);
 
-	if (TotalWeight > 0.0f)
-		gpTracer->FrameBuffer.FrameEstimateTemp(IDx, IDy) = Sum / TotalWeight;
-	else
-		gpTracer->FrameBuffer.FrameEstimateTemp(IDx, IDy) = ColorXYZAf::Black();
+	int X = Interior[0];
+
+#ifdef __AVX2__
+	float TotalWeight = 0.0f;
+
+	for (int i = 0; i <= 2 * Filter.KernelRadius; i++)
+		TotalWeight += Filter.KernelD[i];
+
+	const int Stride = 4 * (Direction[0] * Input.Strides[0] + Direction[1] * Input.Strides[1]);
+
+	const __m256 InvTotalWeight = _mm256_set1_ps(1.0f / TotalWeight);
+
+	// Two XYZA pixels per register, alpha is passed through from the centre tap
+	for (; X + 2 <= Interior[1]; X += 2)
+	{
+		const float* pInput = (const float*)&Input(X, Y);
+
+		__m256 Sum = _mm256_setzero_ps();
+
+		for (int i = -Filter.KernelRadius; i <= Filter.KernelRadius; i++)
+			Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_set1_ps(Filter.KernelD[Filter.KernelRadius + i]), _mm256_loadu_ps(pInput + i * Stride)));
+
+		_mm256_storeu_ps((float*)&Output(X, Y), _mm256_blend_ps(_mm256_mul_ps(Sum, InvTotalWeight), _mm256_loadu_ps(pInput), 0x88));
+	}
+#endif
+
+	for (; X < Resolution[0]; X++)
+		ExposureRender::FilterFrameEstimate(X, Y, Direction, Filter, Input, Output);
 }
 
 void FilterFrameEstimate(Tracer& Tracer)
 {
-	LAUNCH_DIMENSIONS(Tracer.FrameBuffer.Resolution[0], Tracer.FrameBuffer.Resolution[1], 1, 8, 8, 1)
-	LAUNCH_CUDA_KERNEL_TIMED((KrnlFilterFrameEstimate<<<GridDim, BlockDim>>>(1, 1.0f)), "Gaussian filter (Horizontal)");
+	FrameBuffer& FrameBuffer = Tracer.FrameBuffer;
 
-	Tracer.FrameBuffer.FrameEstimateTemp.Dirty = true;
+	{
+		ScopedTiming Timing(gpTimings, "Gaussian filter (Horizontal)");
+
+		gThreadPool.ParallelFor(FrameBuffer.Resolution[1], [&](const int& Y)
+		{
+			FilterFrameEstimate(Y, Vec2i(1, 0), Tracer.FrameFilter, FrameBuffer.FrameEstimate.GetView(), FrameBuffer.FrameEstimateTemp.GetView());
+		});
+	}
+
+	{
+		ScopedTiming Timing(gpTimings, "Gaussian filter (Vertical)");
+
+		gThreadPool.ParallelFor(FrameBuffer.Resolution[1], [&](const int& Y)
+		{
+			FilterFrameEstimate(Y, Vec2i(0, 1), Tracer.FrameFilter, FrameBuffer.FrameEstimateTemp.GetView(), FrameBuffer.FilteredFrameEstimate.GetView());
+		});
+	}
+}
 
-	Tracer.FrameBuffer.FrameEstimate = Tracer.FrameBuffer.FrameEstimateTemp;
 }
 
 }
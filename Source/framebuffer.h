@@ -25,15 +25,15 @@ public:
 		Resolution(),
 		FrameEstimate(Enums::Device, "Frame Estimate XYZA"),
 		FrameEstimateTemp(Enums::Device, "Temp Frame Estimate XYZA"),
+		FilteredFrameEstimate(Enums::Device, "Filtered Frame Estimate XYZA"),
 		RunningEstimateXyza(Enums::Device, "Running Estimate XYZA"),
+		RunningStatistics(Enums::Device, "Running Sample Statistics"),
+		NoSamples(Enums::Device, "No. Samples"),
 		DisplayEstimate(Enums::Device, "Display Estimate RGBA"),
 		DisplayEstimateTemp(Enums::Device, "Temp Display Estimate RGBA"),
 		DisplayEstimateFiltered(Enums::Device, "Filtered Display Estimate RGBA"),
-		RandomSeeds1(Enums::Device, "Random Seeds 1"),
-		RandomSeeds2(Enums::Device, "Random Seeds 2"),
-		RandomSeedsCopy1(Enums::Device, "Random Seeds 1 (Cache)"),
-		RandomSeedsCopy2(Enums::Device, "Random Seeds 2 (Cache)"),
-		HostDisplayEstimate(Enums::Host, "Display Estimate RGBA")
+		HostDisplayEstimate(Enums::Host, "Display Estimate RGBA"),
+		TileTimings(Enums::Host, "Tile Timings")
 	{
 	}
 
@@ -46,41 +46,47 @@ public:
 
 		this->FrameEstimate.Resize(this->Resolution);
 		this->FrameEstimateTemp.Resize(this->Resolution);
+		this->FilteredFrameEstimate.Resize(this->Resolution);
 		this->RunningEstimateXyza.Resize(this->Resolution);
+		this->RunningStatistics.Resize(this->Resolution);
+		this->NoSamples.Resize(this->Resolution);
 		this->DisplayEstimate.Resize(this->Resolution);
 		this->DisplayEstimateTemp.Resize(this->Resolution);
 		this->DisplayEstimateFiltered.Resize(this->Resolution);
-		this->RandomSeeds1.Resize(this->Resolution);
-		this->RandomSeeds2.Resize(this->Resolution);
-		this->RandomSeedsCopy1.Resize(this->Resolution);
-		this->RandomSeedsCopy2.Resize(this->Resolution);
 		this->HostDisplayEstimate.Resize(this->Resolution);
-
-		RandomSeedsCopy1 = RandomSeeds1;
-		RandomSeedsCopy2 = RandomSeeds2;
-
-		this->Reset();
 	}
 
-	void Reset(void)
+	void SetMemoryType(const Enums::MemoryType& MemoryType)
 	{
-		RandomSeeds1 = RandomSeedsCopy1;
-		RandomSeeds2 = RandomSeedsCopy2;
+		if (this->FrameEstimate.MemoryType == MemoryType)
+			return;
+
+		this->Free();
+
+		this->FrameEstimate.SetMemoryType(MemoryType);
+		this->FrameEstimateTemp.SetMemoryType(MemoryType);
+		this->FilteredFrameEstimate.SetMemoryType(MemoryType);
+		this->RunningEstimateXyza.SetMemoryType(MemoryType);
+		this->RunningStatistics.SetMemoryType(MemoryType);
+		this->NoSamples.SetMemoryType(MemoryType);
+		this->DisplayEstimate.SetMemoryType(MemoryType);
+		this->DisplayEstimateTemp.SetMemoryType(MemoryType);
+		this->DisplayEstimateFiltered.SetMemoryType(MemoryType);
 	}
 
 	void Free(void)
 	{
 		this->FrameEstimate.Free();
 		this->FrameEstimateTemp.Free();
+		this->FilteredFrameEstimate.Free();
 		this->RunningEstimateXyza.Free();
+		this->RunningStatistics.Free();
+		this->NoSamples.Free();
 		this->DisplayEstimate.Free();
 		this->DisplayEstimateTemp.Free();
 		this->DisplayEstimateFiltered.Free();
-		this->RandomSeeds1.Free();
-		this->RandomSeeds2.Free();
-		this->RandomSeedsCopy1.Free();
-		this->RandomSeedsCopy2.Free();
 		this->HostDisplayEstimate.Free();
+		this->TileTimings.Free();
 
 		this->Resolution = Vec2i(0);
 	}
@@ -88,15 +94,15 @@ public:
 	Vec2i					Resolution;
 	Buffer2D<ColorXYZAf>	FrameEstimate;
 	Buffer2D<ColorXYZAf>	FrameEstimateTemp;
+	Buffer2D<ColorXYZAf>	FilteredFrameEstimate;
 	Buffer2D<ColorXYZAf>	RunningEstimateXyza;
+	Buffer2D<Vec4f>			RunningStatistics;		// Mean and second moment of the unfiltered luminance and coverage samples
+	Buffer2D<int>			NoSamples;
 	Buffer2D<ColorRGBAuc>	DisplayEstimate;
 	Buffer2D<ColorRGBAuc>	DisplayEstimateTemp;
 	Buffer2D<ColorRGBAuc>	DisplayEstimateFiltered;
-	RandomSeedBuffer2D		RandomSeeds1;
-	RandomSeedBuffer2D		RandomSeeds2;
-	RandomSeedBuffer2D		RandomSeedsCopy1;
-	RandomSeedBuffer2D		RandomSeedsCopy2;
 	Buffer2D<ColorRGBAuc>	HostDisplayEstimate;
+	Buffer2D<float>			TileTimings;
 };
 
 }
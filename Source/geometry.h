@@ -79,6 +79,49 @@ HOST_DEVICE inline Vec2f SphericalToUV(const Vec3f& W)
 	return Vec2f(INV_TWO_PI_F * SphericalPhi(V), 1.0f - (INV_PI_F * SphericalTheta(V)));
 }
 
+HOST_DEVICE inline unsigned short EncodeOctahedral(const Vec3f& N)
+{
+	const float L1 = fabsf(N[0]) + fabsf(N[1]) + fabsf(N[2]);
+
+	if (L1 <= 0.0f)
+		return 0x8080;
+
+	float X = N[0] / L1, Y = N[1] / L1;
+
+	if (N[2] < 0.0f)
+	{
+		const float FX = (1.0f - fabsf(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+		const float FY = (1.0f - fabsf(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+
+		X = FX;
+		Y = FY;
+	}
+
+	const unsigned short U = (unsigned short)(Clamp(X * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+	const unsigned short V = (unsigned short)(Clamp(Y * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+	return (V << 8) | U;
+}
+
+HOST_DEVICE inline Vec3f DecodeOctahedral(const unsigned short& Code)
+{
+	float X = (float)(Code & 0xFF) / 255.0f * 2.0f - 1.0f;
+	float Y = (float)(Code >> 8) / 255.0f * 2.0f - 1.0f;
+
+	const float Z = 1.0f - fabsf(X) - fabsf(Y);
+
+	if (Z < 0.0f)
+	{
+		const float FX = (1.0f - fabsf(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+		const float FY = (1.0f - fabsf(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+
+		X = FX;
+		Y = FY;
+	}
+
+	return Normalize(Vec3f(X, Y, Z));
+}
+
 HOST_DEVICE inline float Lerp(float t, float v1, float v2)
 {
 	return (1.f - t) * v1 + t * v2;
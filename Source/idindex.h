@@ -0,0 +1,147 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "defines.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+// Open addressed map from resource ID to slot, with linear probing and backward shift deletion
+class IDIndex
+{
+public:
+	HOST IDIndex() :
+		IDs(),
+		Slots(),
+		Size(0)
+	{
+	}
+
+	HOST int GetSize() const
+	{
+		return this->Size;
+	}
+
+	HOST int operator[](const int& ID) const
+	{
+		if (this->IDs.empty())
+			return -1;
+
+		for (int i = this->Hash(ID); this->IDs[i] != -1; i = (i + 1) & this->GetMask())
+		{
+			if (this->IDs[i] == ID)
+				return this->Slots[i];
+		}
+
+		return -1;
+	}
+
+	HOST void Set(const int& ID, const int& Slot)
+	{
+		if (ID < 0)
+			return;
+
+		if (2 * (this->Size + 1) > (int)this->IDs.size())
+			this->Rehash(max(2 * (int)this->IDs.size(), 16));
+
+		int i = this->Hash(ID);
+
+		while (this->IDs[i] != -1 && this->IDs[i] != ID)
+			i = (i + 1) & this->GetMask();
+
+		if (this->IDs[i] == -1)
+			this->Size++;
+
+		this->IDs[i]	= ID;
+		this->Slots[i]	= Slot;
+	}
+
+	HOST void Remove(const int& ID)
+	{
+		if (this->IDs.empty())
+			return;
+
+		int i = this->Hash(ID);
+
+		while (this->IDs[i] != ID)
+		{
+			if (this->IDs[i] == -1)
+				return;
+
+			i = (i + 1) & this->GetMask();
+		}
+
+		// Move later entries of the probe sequence into the hole so lookups never need tombstones
+		for (int j = (i + 1) & this->GetMask(); this->IDs[j] != -1; j = (j + 1) & this->GetMask())
+		{
+			const int Home = this->Hash(this->IDs[j]);
+
+			if (((j - Home) & this->GetMask()) >= ((j - i) & this->GetMask()))
+			{
+				this->IDs[i]	= this->IDs[j];
+				this->Slots[i]	= this->Slots[j];
+				i				= j;
+			}
+		}
+
+		this->IDs[i] = -1;
+		this->Size--;
+	}
+
+	HOST void Clear()
+	{
+		this->IDs.assign(this->IDs.size(), -1);
+		this->Size = 0;
+	}
+
+private:
+	HOST int GetMask() const
+	{
+		return (int)this->IDs.size() - 1;
+	}
+
+	HOST int Hash(const int& ID) const
+	{
+		unsigned int H = (unsigned int)ID * 2654435761u;
+
+		return (int)((H ^ (H >> 16)) & (unsigned int)this->GetMask());
+	}
+
+	HOST void Rehash(const int& Capacity)
+	{
+		vector<int> IDs(Capacity, -1), Slots(Capacity, -1);
+
+		this->IDs.swap(IDs);
+		this->Slots.swap(Slots);
+		this->Size = 0;
+
+		for (size_t i = 0; i < IDs.size(); i++)
+		{
+			if (IDs[i] != -1)
+				this->Set(IDs[i], Slots[i]);
+		}
+	}
+
+	vector<int>		IDs;
+	vector<int>		Slots;
+	int				Size;
+};
+
+}
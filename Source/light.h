@@ -22,7 +22,8 @@ class Light : public ErLight
 {
 public:
 	HOST Light() :
-		ErLight()
+		ErLight(),
+		TextureSlot(-1)
 	{
 	}
 
@@ -36,8 +37,12 @@ public:
 		ErLight::operator=(Other);
 		this->Shape.Update();
 
+		this->TextureSlot = -1;
+
 		return *this;
 	}
+
+	int		TextureSlot;
 };
 
 }
@@ -42,7 +42,7 @@ HOST_DEVICE_NI void SampleLight(const Light& Light, LightSample& LS, SurfaceSamp
 
 	Wi = Normalize(SS.P - SE.P);
 
-	Le = Light.Multiplier * EvaluateTexture(Light.TextureID, SS.UV);
+	Le = Light.Multiplier * EvaluateTexture(Light.TextureSlot, SS.UV);
 	
 	if (Light.Shape.OneSided && Dot(SE.P - SS.P, SS.N) < 0.0f)
 		Le = ColorXYZf::Black();
@@ -75,7 +75,7 @@ HOST_DEVICE_NI void IntersectLight(const Light& Light, const Ray& R, ScatterEven
 		SE.T 		= Length(SE.P - R.O);
 		SE.Wo		= -R.D;
 		SE.UV		= Int.UV;
-		SE.Le		= Int.Front ? Light.Multiplier * EvaluateTexture(Light.TextureID, SE.UV) : ColorXYZf::Black();
+		SE.Le		= Int.Front ? Light.Multiplier * EvaluateTexture(Light.TextureSlot, SE.UV) : ColorXYZf::Black();
 		
 		if (Light.Unit == 1)
 			SE.Le /= Light.Shape.Area;
@@ -86,9 +86,13 @@ HOST_DEVICE_NI void IntersectLights(const Ray& R, ScatterEvent& RS, bool Respect
 {
 	float T = FLT_MAX; 
 
-	for (int i = 0; i < gpTracer->LightIDs.Count; i++)
+	BVHTraversal Traversal(gpTracer->LightBVH, R);
+
+	int i = 0;
+
+	while (Traversal.Next(i, T))
 	{
-		const Light& Light = gpLights[gpTracer->LightIDs[i]];
+		const Light& Light = gpLights[gpTracer->LightSlots[i]];
 		
 		ScatterEvent LocalRS(Enums::Light);
 
@@ -114,9 +118,13 @@ HOST_DEVICE_NI bool IntersectsLight(const Light& Light, const Ray& R)
 
 HOST_DEVICE_NI bool IntersectsLight(const Ray& R)
 {
-	for (int i = 0; i < gpTracer->LightIDs.Count; i++)
+	BVHTraversal Traversal(gpTracer->LightBVH, R);
+
+	int i = 0;
+
+	while (Traversal.Next(i))
 	{
-		const Light& Light = gpLights[gpTracer->LightIDs[i]];
+		const Light& Light = gpLights[gpTracer->LightSlots[i]];
 
 		if (IntersectsLight(Light, R))
 			return true;
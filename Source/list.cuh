@@ -13,24 +13,40 @@
 
 #pragma once
 
+#include "idindex.h"
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
 namespace ExposureRender
 {
 
 namespace Cuda
 {
 
-template<typename D, typename H, int MaxSize = 32>
+template<typename D, typename H>
 class List
 {
 public:
-	HOST List(const char* pDeviceSymbol) :
-		Map(),
-		MapIt(),
-		HashMap(),
-		HashMapIt(),
+	HOST List(const char* pDeviceSymbol, D** ppHostSymbol) :
+		Items(),
+		IDs(),
+		Index(),
+		HostList(NULL),
 		DeviceList(NULL),
 		Counter(0),
-		DeviceSymbol()
+		Version(0),
+		DeviceSymbol(),
+		pHostSymbol(ppHostSymbol),
+		NoSlots(0),
+		Capacity(0),
+		DeviceCapacity(0),
+		HostItem(NULL),
+		DeviceItem(NULL),
+		ItemID(-1),
+		pDeviceSymbolValue(NULL)
 	{
 		DebugLog(__FUNCTION__);
 		sprintf_s(DeviceSymbol, MAX_CHAR_SIZE, "%s", pDeviceSymbol);
@@ -39,63 +55,77 @@ public:
 	HOST ~List()
 	{
 		DebugLog(__FUNCTION__);
+
+		free(this->HostList);
+		free(this->HostItem);
 	}
 	
-	HOST bool Exists(const int& ID)
+	HOST int GetSize() const
 	{
-		if (ID < 0)
-			return false;
+		return (int)this->Items.size();
+	}
 
-		this->MapIt = this->Map.find(ID);
+	HOST D* Find(const int& ID) const
+	{
+		const int Slot = this->Index[ID];
 
-		return this->MapIt != this->Map.end();
+		return Slot < 0 ? NULL : this->Items[Slot];
 	}
 
-	HOST void Bind(const H& Item)
+	HOST bool Exists(const int& ID) const
+	{
+		return this->Find(ID) != NULL;
+	}
+
+	// Binding an rvalue lets the item take over the data of the bindable instead of copying it
+	template<typename T>
+	HOST void Bind(T&& Item)
 	{
 		DebugLog(__FUNCTION__);
 
-		if (this->Map.size() + 1 >= MaxSize)
-		{
-			DebugLog("%s failed, max. no. items reached", __FUNCTION__);
-			return;
-		}
-		
-		const bool Exists = this->Exists(Item.ID);
+		D* pItem = this->Find(Item.ID);
 		
-		if (!Exists)
+		if (pItem == NULL)
 		{
 			Item.ID = this->Counter;
-			this->Map[Item.ID] = new D(Item);
+			this->Index.Set(Item.ID, (int)this->Items.size());
+			this->Items.push_back(new D(forward<T>(Item)));
+			this->IDs.push_back(Item.ID);
 			this->Counter++;
 		}
 		else
 		{
-			*(this->Map[Item.ID]) = Item;
+			*pItem = forward<T>(Item);
 		}
 
 		this->Synchronize();
 	}
 
+	// The last item moves into the slot of the removed one, so only those two slots change
 	HOST void Unbind(const H& Item)
 	{
 		DebugLog(__FUNCTION__);
 
-		if (!this->Exists(Item.ID))
+		const int Slot = this->Index[Item.ID];
+
+		if (Slot < 0)
 		{
 			DebugLog("%s failed, resource item with ID:%d does not exist", __FUNCTION__, Item.ID);
 			return;
 		}
 		
-		delete this->Map[Item.ID];
-				
-		this->MapIt = this->Map.find(Item.ID);
-		this->Map.erase(this->MapIt);
+		delete this->Items[Slot];
 
-		this->HashMapIt = this->HashMap.find(Item.ID);
+		this->Items[Slot]	= this->Items.back();
+		this->IDs[Slot]		= this->IDs.back();
 
-		if (this->HashMapIt != this->HashMap.end())
-			this->HashMap.erase(this->HashMapIt);
+		this->Items.pop_back();
+		this->IDs.pop_back();
+
+		this->Index.Remove(Item.ID);
+
+		if (Slot < (int)this->Items.size())
+			this->Index.Set(this->IDs[Slot], Slot);
 
 		this->Synchronize();
 	}
@@ -104,67 +134,183 @@ public:
 	{
 //		DebugLog(__FUNCTION__);
 
-		if (this->Map.size() <= 0)
-			return; // DebugLog("%s failed, map is empty", __FUNCTION__);
+		this->Version++;
+
+		if (this->Items.empty())
+			return; // DebugLog("%s failed, list is empty", __FUNCTION__);
 
 		if (ID == 0)
+			this->SynchronizeList();
+		else
+			this->SynchronizeItem(ID);
+	}
+
+	HOST D& operator[](const int& i)
+	{
+//		DebugLog(__FUNCTION__);
+
+		D* pItem = this->Find(i);
+
+		if (pItem == NULL)
 		{
-			D* pHostList = (D*)malloc(this->Map.size() * sizeof(D));
-		
-			int Size = 0;
+			char Message[MAX_CHAR_SIZE];
+
+			sprintf_s(Message, MAX_CHAR_SIZE, "%s failed, resource item with ID:%d does not exist", __FUNCTION__, i);
+
+			throw(Exception(Enums::Warning, Message));
+		}
+
+		return *pItem;
+	}
+
+private:
+	// Slots are compared against the copy that was last uploaded, only the changed byte ranges go to the device
+	HOST void SynchronizeList()
+	{
+		const int Size = (int)this->Items.size();
+
+		if (Size > this->Capacity)
+		{
+			this->Capacity = max(2 * this->Capacity, Size);
+			this->HostList = (D*)realloc(this->HostList, this->Capacity * sizeof(D));
+		}
+
+		const bool Upload		= Cuda::DeviceAvailable();
+		const bool Reallocate	= Upload && Size > this->DeviceCapacity;
+
+		int RunBegin	= -1;
+		int RunEnd		= -1;
+		int Begin		= 0;
+		int End			= 0;
+
+		for (int Slot = 0; Slot < Size; Slot++)
+		{
+			if (!Update(this->HostList[Slot], *this->Items[Slot], Slot >= this->NoSlots, Begin, End))
+				continue;
+
+			Begin	+= Slot * sizeof(D);
+			End		+= Slot * sizeof(D);
 
-			for (this->MapIt = this->Map.begin(); this->MapIt != this->Map.end(); this->MapIt++)
+			// Changes in neighbouring slots are merged into one copy
+			if (RunBegin >= 0 && Begin - RunEnd >= (int)sizeof(D))
 			{
-				memcpy((void*)&pHostList[Size], (void*)this->MapIt->second, sizeof(D));
-				HashMap[this->MapIt->first] = Size;
-				Size++;
+				if (Upload && !Reallocate)
+					Cuda::MemCopyHostToDeviceRange(this->HostList, this->DeviceList, RunBegin, RunEnd - RunBegin);
+
+				RunBegin = -1;
 			}
-			
+
+			if (RunBegin < 0)
+				RunBegin = Begin;
+
+			RunEnd = End;
+		}
+
+		this->NoSlots = Size;
+
+		*this->pHostSymbol = this->HostList;
+
+		if (!Upload)
+			return;
+
+		if (Reallocate)
+		{
 			Cuda::Free(this->DeviceList);
-			Cuda::Allocate(this->DeviceList, (int)this->Map.size());
-			Cuda::MemCopyHostToDevice(pHostList, this->DeviceList, Size);
-			Cuda::MemCopyHostToDeviceSymbol(&this->DeviceList, this->DeviceSymbol);
-		
-			free(pHostList);
+			Cuda::Allocate(this->DeviceList, this->Capacity);
+			Cuda::MemCopyHostToDevice(this->HostList, this->DeviceList, Size);
+
+			this->DeviceCapacity = this->Capacity;
 		}
-		else
+		else if (RunBegin >= 0)
 		{
-			if (!this->Exists(ID))
-				return;
+			Cuda::MemCopyHostToDeviceRange(this->HostList, this->DeviceList, RunBegin, RunEnd - RunBegin);
+		}
 
-			Cuda::Free(this->DeviceList);
-			Cuda::Allocate(this->DeviceList);
-			
-			this->MapIt = this->Map.find(ID);
+		this->SetDeviceSymbol(this->DeviceList);
+	}
 
-			Cuda::MemCopyHostToDevice(this->MapIt->second, this->DeviceList);
-			Cuda::MemCopyHostToDeviceSymbol(&this->DeviceList, this->DeviceSymbol);
+	HOST void SynchronizeItem(const int& ID)
+	{
+		D* pItem = this->Find(ID);
+
+		if (pItem == NULL)
+			return;
+
+		*this->pHostSymbol = pItem;
+
+		if (!Cuda::DeviceAvailable())
+			return;
+
+		if (this->DeviceItem == NULL)
+		{
+			this->HostItem = (D*)malloc(sizeof(D));
+			Cuda::Allocate(this->DeviceItem);
 		}
+
+		int Begin = 0, End = 0;
+
+		if (Update(*this->HostItem, *pItem, this->ItemID != ID, Begin, End))
+			Cuda::MemCopyHostToDeviceRange(this->HostItem, this->DeviceItem, Begin, End - Begin);
+
+		this->ItemID = ID;
+
+		this->SetDeviceSymbol(this->DeviceItem);
 	}
 
-	HOST D& operator[](const int& i)
+	HOST static bool Update(D& Shadow, const D& Item, const bool& Force, int& Begin, int& End)
 	{
-//		DebugLog(__FUNCTION__);
+		const unsigned char* pShadow	= (const unsigned char*)&Shadow;
+		const unsigned char* pItem		= (const unsigned char*)&Item;
+
+		Begin	= 0;
+		End		= sizeof(D);
 
-		if (!this->Exists(i))
+		if (!Force)
 		{
-			char Message[MAX_CHAR_SIZE];
+			if (memcmp(pShadow, pItem, sizeof(D)) == 0)
+				return false;
 
-			sprintf_s(Message, MAX_CHAR_SIZE, "%s failed, resource item with ID:%d does not exist", __FUNCTION__, i);
+			while (Begin < End && pShadow[Begin] == pItem[Begin])
+				Begin++;
 
-			throw(Exception(Enums::Warning, Message));
+			while (End > Begin && pShadow[End - 1] == pItem[End - 1])
+				End--;
 		}
 
-		return *this->Map[i];
+		memcpy((unsigned char*)&Shadow + Begin, pItem + Begin, End - Begin);
+
+		return true;
+	}
+
+	HOST void SetDeviceSymbol(D* pDevice)
+	{
+		if (pDevice == this->pDeviceSymbolValue)
+			return;
+
+		Cuda::MemCopyHostToDeviceSymbol(&pDevice, this->DeviceSymbol);
+
+		this->pDeviceSymbolValue = pDevice;
 	}
 
-	map<int, D*>						Map;
-	typename map<int, D*>::iterator		MapIt;
-	map<int, int>						HashMap;
-	typename map<int, int>::iterator	HashMapIt;
+public:
+	vector<D*>							Items;
+	vector<int>							IDs;
+	IDIndex								Index;
+	D*									HostList;
 	D*									DeviceList;
 	int									Counter;
+	int									Version;
 	char								DeviceSymbol[MAX_CHAR_SIZE];
+	D**									pHostSymbol;
+
+private:
+	int									NoSlots;
+	int									Capacity;
+	int									DeviceCapacity;
+	D*									HostItem;
+	D*									DeviceItem;
+	int									ItemID;
+	D*									pDeviceSymbolValue;
 };
 
 }
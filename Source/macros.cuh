@@ -53,7 +53,8 @@ namespace Cuda
 																											\
 	Cuda::HandleCudaError(cudaEventElapsedTime(&TimeDelta, EventStart, EventStop), title);					\
 																											\
-	/*gKernelTimings.Add(ErKernelTiming(title, TimeDelta));*/												\
+	if (gpTimings != NULL)																					\
+		gpTimings->Add(title, TimeDelta);																	\
 																											\
 	Cuda::HandleCudaError(cudaEventDestroy(EventStart));													\
 	Cuda::HandleCudaError(cudaEventDestroy(EventStop));														\
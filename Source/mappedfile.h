@@ -0,0 +1,168 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "defines.h"
+#include "enums.h"
+#include "exception.h"
+#include "log.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ExposureRender
+{
+
+namespace Host
+{
+
+// Read-only view of a whole file, pages are loaded on first access and shared with the OS file cache
+class MappedFile
+{
+public:
+	HOST MappedFile(const char* pFileName) :
+#ifdef _WIN32
+		File(INVALID_HANDLE_VALUE),
+		Mapping(NULL),
+#else
+		File(-1),
+#endif
+		Data(NULL),
+		NoBytes(0)
+	{
+		DebugLog("%s: %s", __FUNCTION__, pFileName);
+
+#ifdef _WIN32
+		this->File = CreateFileA(pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+
+		LARGE_INTEGER Size;
+
+		if (this->File == INVALID_HANDLE_VALUE || !GetFileSizeEx(this->File, &Size))
+			this->Fail("open", pFileName);
+
+		this->NoBytes = Size.QuadPart;
+
+		if (this->NoBytes > 0)
+		{
+			this->Mapping	= CreateFileMappingA(this->File, NULL, PAGE_READONLY, 0, 0, NULL);
+			this->Data		= this->Mapping != NULL ? MapViewOfFile(this->Mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		}
+#else
+		this->File = open(pFileName, O_RDONLY);
+
+		struct stat Stat;
+
+		if (this->File < 0 || fstat(this->File, &Stat) != 0)
+			this->Fail("open", pFileName);
+
+		this->NoBytes = Stat.st_size;
+
+		if (this->NoBytes > 0)
+		{
+			this->Data = mmap(NULL, this->NoBytes, PROT_READ, MAP_SHARED, this->File, 0);
+
+			if (this->Data == MAP_FAILED)
+				this->Data = NULL;
+		}
+#endif
+
+		if (this->NoBytes > 0 && this->Data == NULL)
+			this->Fail("map", pFileName);
+	}
+
+	HOST ~MappedFile()
+	{
+		DebugLog(__FUNCTION__);
+		this->Close();
+	}
+
+	HOST const void* GetData() const
+	{
+		return this->Data;
+	}
+
+	HOST long long GetNoBytes() const
+	{
+		return this->NoBytes;
+	}
+
+private:
+	MappedFile(const MappedFile& Other);
+	MappedFile& operator = (const MappedFile& Other);
+
+	HOST void Fail(const char* pAction, const char* pFileName)
+	{
+		this->Close();
+
+		char Message[MAX_CHAR_SIZE];
+
+		sprintf_s(Message, MAX_CHAR_SIZE, "Unable to %s %s", pAction, pFileName);
+
+		throw(Exception(Enums::Error, Message));
+	}
+
+	HOST void Close()
+	{
+#ifdef _WIN32
+		if (this->Data != NULL)
+			UnmapViewOfFile(this->Data);
+
+		if (this->Mapping != NULL)
+			CloseHandle(this->Mapping);
+
+		if (this->File != INVALID_HANDLE_VALUE)
+			CloseHandle(this->File);
+
+		this->File		= INVALID_HANDLE_VALUE;
+		this->Mapping	= NULL;
+#else
+		if (this->Data != NULL)
+			munmap(this->Data, this->NoBytes);
+
+		if (this->File >= 0)
+			close(this->File);
+
+		this->File = -1;
+#endif
+
+		this->Data		= NULL;
+		this->NoBytes	= 0;
+	}
+
+#ifdef _WIN32
+	HANDLE		File;
+	HANDLE		Mapping;
+#else
+	int			File;
+#endif
+	void*		Data;
+	long long	NoBytes;
+};
+
+}
+
+}
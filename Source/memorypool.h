@@ -0,0 +1,289 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "defines.h"
+#include "enums.h"
+#include "log.h"
+#include "wrapper.cuh"
+
+#include <vector>
+#include <mutex>
+#include <stdlib.h>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+#define MEMORY_POOL_ALIGNMENT			128
+#define MEMORY_POOL_MIN_BLOCK_SIZE		256
+#define MEMORY_POOL_NO_SIZE_CLASSES		256
+
+class EXPOSURE_RENDER_DLL MemoryPoolStatistics
+{
+public:
+	HOST MemoryPoolStatistics() :
+		NoAllocations(0),
+		NoSystemAllocations(0),
+		NoReleases(0),
+		NoSystemReleases(0),
+		BytesInUse(0),
+		BytesCached(0),
+		PeakBytesInUse(0)
+	{
+	}
+
+	long long	NoAllocations;
+	long long	NoSystemAllocations;
+	long long	NoReleases;
+	long long	NoSystemReleases;
+	long long	BytesInUse;
+	long long	BytesCached;
+	long long	PeakBytesInUse;
+};
+
+// Blocks are rounded up to one of four size classes per power of two and kept for reuse when released
+class MemoryPool
+{
+public:
+	HOST static MemoryPool& Get()
+	{
+		static MemoryPool Pool;
+		return Pool;
+	}
+
+	HOST ~MemoryPool()
+	{
+		// The CUDA context may already be gone at exit, so only host blocks are returned
+		this->Trim(Enums::Host);
+	}
+
+	HOST void* Allocate(const Enums::MemoryType& MemoryType, const size_t& NoBytes)
+	{
+		if (NoBytes == 0)
+			return NULL;
+
+#ifndef __CUDACC__
+		if (MemoryType == Enums::Device)
+			return NULL;
+#endif
+
+		size_t BlockSize = 0;
+
+		const int SizeClass = GetSizeClass(NoBytes, BlockSize);
+
+		lock_guard<mutex> Lock(this->Mutex);
+
+		MemoryPoolStatistics& Statistics = this->Statistics[MemoryType];
+
+		vector<void*>& FreeBlocks = this->FreeBlocks[MemoryType][SizeClass];
+
+		void* pBlock = NULL;
+
+		if (!FreeBlocks.empty())
+		{
+			pBlock = FreeBlocks.back();
+			FreeBlocks.pop_back();
+
+			Statistics.BytesCached -= BlockSize;
+		}
+		else
+		{
+			pBlock = this->SystemAllocate(MemoryType, BlockSize);
+
+			if (pBlock == NULL)
+			{
+				this->Evict(MemoryType, 0);
+				pBlock = this->SystemAllocate(MemoryType, BlockSize);
+			}
+
+			if (pBlock == NULL)
+				throw(Exception(Enums::Error, "Memory pool allocation failed"));
+
+			Statistics.NoSystemAllocations++;
+		}
+
+		Statistics.NoAllocations++;
+		Statistics.BytesInUse		+= BlockSize;
+		Statistics.PeakBytesInUse	= max(Statistics.PeakBytesInUse, Statistics.BytesInUse);
+
+		return pBlock;
+	}
+
+	HOST void Release(const Enums::MemoryType& MemoryType, void* pBlock, const size_t& NoBytes)
+	{
+		if (pBlock == NULL)
+			return;
+
+		size_t BlockSize = 0;
+
+		const int SizeClass = GetSizeClass(NoBytes, BlockSize);
+
+		lock_guard<mutex> Lock(this->Mutex);
+
+		MemoryPoolStatistics& Statistics = this->Statistics[MemoryType];
+
+		this->FreeBlocks[MemoryType][SizeClass].push_back(pBlock);
+
+		Statistics.NoReleases++;
+		Statistics.BytesInUse	-= BlockSize;
+		Statistics.BytesCached	+= BlockSize;
+
+		if (Statistics.BytesCached > this->MaxCachedBytes[MemoryType])
+			this->Evict(MemoryType, this->MaxCachedBytes[MemoryType]);
+	}
+
+	HOST void Trim(const Enums::MemoryType& MemoryType)
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		this->Evict(MemoryType, 0);
+	}
+
+	HOST void SetMaxCachedBytes(const Enums::MemoryType& MemoryType, const long long& MaxCachedBytes)
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		this->MaxCachedBytes[MemoryType] = MaxCachedBytes;
+
+		this->Evict(MemoryType, MaxCachedBytes);
+	}
+
+	HOST MemoryPoolStatistics GetStatistics(const Enums::MemoryType& MemoryType)
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		return this->Statistics[MemoryType];
+	}
+
+	HOST static int GetSizeClass(const size_t& NoBytes, size_t& BlockSize)
+	{
+		if (NoBytes <= MEMORY_POOL_MIN_BLOCK_SIZE)
+		{
+			BlockSize = MEMORY_POOL_MIN_BLOCK_SIZE;
+			return 0;
+		}
+
+		int Octave = 0;
+
+		while (((size_t)2 << Octave) <= NoBytes - 1)
+			Octave++;
+
+		int MinOctave = 0;
+
+		while (((size_t)2 << MinOctave) <= MEMORY_POOL_MIN_BLOCK_SIZE)
+			MinOctave++;
+
+		const size_t Base	= (size_t)1 << Octave;
+		const size_t Step	= Base / 4;
+		const size_t Steps	= (NoBytes - Base + Step - 1) / Step;
+
+		BlockSize = Base + Steps * Step;
+
+		return 1 + (Octave - MinOctave) * 4 + (int)Steps - 1;
+	}
+
+private:
+	HOST MemoryPool() :
+		Mutex()
+	{
+		this->MaxCachedBytes[Enums::Host]	= 512ll * 1024 * 1024;
+		this->MaxCachedBytes[Enums::Device]	= 512ll * 1024 * 1024;
+	}
+
+	HOST MemoryPool(const MemoryPool& Other);
+	HOST MemoryPool& operator = (const MemoryPool& Other);
+
+	// Returns cached blocks to the system, largest first, until at most MaxCachedBytes remain
+	HOST void Evict(const Enums::MemoryType& MemoryType, const long long& MaxCachedBytes)
+	{
+		MemoryPoolStatistics& Statistics = this->Statistics[MemoryType];
+
+		for (int SizeClass = MEMORY_POOL_NO_SIZE_CLASSES - 1; SizeClass >= 0 && Statistics.BytesCached > MaxCachedBytes; SizeClass--)
+		{
+			vector<void*>& FreeBlocks = this->FreeBlocks[MemoryType][SizeClass];
+
+			while (!FreeBlocks.empty() && Statistics.BytesCached > MaxCachedBytes)
+			{
+				this->SystemFree(MemoryType, FreeBlocks.back());
+				FreeBlocks.pop_back();
+
+				Statistics.BytesCached -= GetBlockSize(SizeClass);
+				Statistics.NoSystemReleases++;
+			}
+		}
+	}
+
+	HOST static size_t GetBlockSize(const int& SizeClass)
+	{
+		if (SizeClass == 0)
+			return MEMORY_POOL_MIN_BLOCK_SIZE;
+
+		const size_t Base = (size_t)MEMORY_POOL_MIN_BLOCK_SIZE << ((SizeClass - 1) / 4);
+
+		return Base + (((SizeClass - 1) % 4) + 1) * (Base / 4);
+	}
+
+	HOST static void* SystemAllocate(const Enums::MemoryType& MemoryType, const size_t& NoBytes)
+	{
+		void* pBlock = NULL;
+
+		if (MemoryType == Enums::Host)
+		{
+#ifdef _WIN32
+			pBlock = _aligned_malloc(NoBytes, MEMORY_POOL_ALIGNMENT);
+#else
+			if (posix_memalign(&pBlock, MEMORY_POOL_ALIGNMENT, NoBytes) != 0)
+				pBlock = NULL;
+#endif
+		}
+
+#ifdef __CUDACC__
+		// cudaMalloc aligns to at least 256 bytes
+		if (MemoryType == Enums::Device && cudaMalloc(&pBlock, NoBytes) != cudaSuccess)
+		{
+			cudaGetLastError();
+			pBlock = NULL;
+		}
+#endif
+
+		return pBlock;
+	}
+
+	HOST static void SystemFree(const Enums::MemoryType& MemoryType, void* pBlock)
+	{
+		if (MemoryType == Enums::Host)
+		{
+#ifdef _WIN32
+			_aligned_free(pBlock);
+#else
+			free(pBlock);
+#endif
+		}
+
+#ifdef __CUDACC__
+		if (MemoryType == Enums::Device)
+			Cuda::Free(pBlock);
+#endif
+	}
+
+	mutex					Mutex;
+	vector<void*>			FreeBlocks[2][MEMORY_POOL_NO_SIZE_CLASSES];
+	MemoryPoolStatistics	Statistics[2];
+	long long				MaxCachedBytes[2];
+};
+
+}
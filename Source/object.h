@@ -22,7 +22,10 @@ class EXPOSURE_RENDER_DLL Object : public ErObject
 {
 public:
 	HOST Object() :
-		ErObject()
+		ErObject(),
+		DiffuseTextureSlot(-1),
+		SpecularTextureSlot(-1),
+		GlossinessTextureSlot(-1)
 	{
 	}
 
@@ -35,8 +38,16 @@ public:
 	{
 		ErObject::operator=(Other);
 
+		this->DiffuseTextureSlot	= -1;
+		this->SpecularTextureSlot	= -1;
+		this->GlossinessTextureSlot	= -1;
+
 		return *this;
 	}
+
+	int		DiffuseTextureSlot;
+	int		SpecularTextureSlot;
+	int		GlossinessTextureSlot;
 };
 
 }
@@ -42,13 +42,17 @@ HOST_DEVICE_NI void IntersectObjects(const Ray& R, ScatterEvent& RS)
 {
 	float T = FLT_MAX;
 
-	for (int i = 0; i < gpTracer->ObjectIDs.Count; i++)
+	BVHTraversal Traversal(gpTracer->ObjectBVH, R);
+
+	int i = 0;
+
+	while (Traversal.Next(i, T))
 	{
-		const Object& Object = gpObjects[i];
+		const Object& Object = gpObjects[gpTracer->ObjectSlots[i]];
 
 		ScatterEvent LocalRS(Enums::Object);
 
-		LocalRS.ObjectID = i;
+		LocalRS.ObjectID = gpTracer->ObjectSlots[i];
 
 		IntersectObject(Object, R, LocalRS);
 
@@ -67,9 +71,13 @@ HOST_DEVICE_NI bool IntersectsObject(const Object& Object, const Ray& R)
 
 HOST_DEVICE_NI bool IntersectsObject(const Ray& R)
 {
-	for (int i = 0; i < gpTracer->ObjectIDs.Count; i++)
+	BVHTraversal Traversal(gpTracer->ObjectBVH, R);
+
+	int i = 0;
+
+	while (Traversal.Next(i))
 	{
-		if (IntersectsObject(gpObjects[i], R))
+		if (IntersectsObject(gpObjects[gpTracer->ObjectSlots[i]], R))
 			return true;
 	}
 	
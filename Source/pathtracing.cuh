@@ -7,29 +7,47 @@
 	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
 	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
 	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
-	
+
 	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+
 #pragma once
 
-#include "geometry.h"
-#include "utilities.h"
+#include "macros.cuh"
+#include "pathtracing.h"
 
 namespace ExposureRender
 {
 
-KERNEL void KrnlComputeEstimate()
+KERNEL void KrnlPathTracing()
 {
 	KERNEL_2D(gpTracer->FrameBuffer.Resolution[0], gpTracer->FrameBuffer.Resolution[1])
 
-	gpTracer->FrameBuffer.RunningEstimateXyza(IDx, IDy) = CumulativeMovingAverage(gpTracer->FrameBuffer.RunningEstimateXyza(IDx, IDy), gpTracer->FrameBuffer.FrameEstimate(IDx, IDy), gpTracer->NoIterations);
+	gpTracer->FrameBuffer.FrameEstimate(IDx, IDy) = PathTracing(gpTracer, Vec2i(IDx, IDy));
 }
 
-void ComputeEstimate(Tracer& Tracer)
+void PathTracing(Tracer& Tracer)
 {
 	LAUNCH_DIMENSIONS(Tracer.FrameBuffer.Resolution[0], Tracer.FrameBuffer.Resolution[1], 1, 16, 8, 1)
-	LAUNCH_CUDA_KERNEL_TIMED((KrnlComputeEstimate<<<GridDim, BlockDim>>>()), "Compute running estimate");
+	LAUNCH_CUDA_KERNEL_TIMED((KrnlPathTracing<<<GridDim, BlockDim>>>()), "Path Tracing"); 
+}
+
+namespace Host
+{
+
+void PathTracing(Tracer& Tracer)
+{
+	ScopedTiming Timing(gpTimings, "Path Tracing");
+
+	gTileScheduler.Run(gThreadPool, Tracer.FrameBuffer.Resolution, Tracer.RenderSettings.Threading.TileSize, Tracer.FrameBuffer.TileTimings, [&](const Vec2i& Min, const Vec2i& Max)
+	{
+		for (int Y = Min[1]; Y < Max[1]; Y++)
+			for (int X = Min[0]; X < Max[0]; X++)
+				Tracer.FrameBuffer.FrameEstimate(X, Y) = ExposureRender::PathTracing(&Tracer, Vec2i(X, Y));
+	});
 }
 
-}
\ No newline at end of file
+}
+
+}
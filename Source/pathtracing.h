@@ -0,0 +1,96 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "singlescattering.h"
+
+namespace ExposureRender
+{
+
+HOST_DEVICE_NI ColorXYZAf PathTracing(Tracer* pTracer, const Vec2i& PixelCoord)
+{
+	if (Converged(PixelCoord[0], PixelCoord[1]))
+		return gpTracer->FrameBuffer.RunningEstimateXyza(PixelCoord[0], PixelCoord[1]);
+
+	CRNG RNG(PixelCoord[1] * gpTracer->FrameBuffer.Resolution[0] + PixelCoord[0], gpTracer->NoIterations);
+
+	ColorXYZf Lv = ColorXYZf::Black(), Throughput(1.0f);
+
+	MetroSample Sample;
+
+	Ray R;
+
+	SamplePixel(PixelCoord, RNG, Sample, R);
+
+	ScatterEvent SE = SampleRay(R, RNG);
+
+	const bool Valid = SE.Valid;
+
+	LightingSample LS = Sample.LightingSample;
+
+	for (int Depth = 0; SE.Valid; Depth++)
+	{
+		// Beyond the camera vertex, light hits are already counted by the BSDF half of the direct lighting estimate
+		if (SE.Type == Enums::Light)
+		{
+			if (Depth == 0)
+				Lv += SE.Le;
+
+			break;
+		}
+
+		ColorXYZf Emission;
+
+		Shader Shader;
+
+		GetShading(SE, Emission, Shader);
+
+		Lv += Throughput * (Emission + SampleOneLight(SE, RNG, LS, Shader));
+
+		if (Depth + 1 >= gpTracer->RenderSettings.Integrator.MaxDepth)
+			break;
+
+		Vec3f Wi;
+
+		float Pdf = 0.0f;
+
+		ColorXYZf F = Shader.SampleF(SE.Wo, Wi, Pdf, BrdfSample(RNG));
+
+		if (F.IsBlack() || !(Pdf > 0.0f))
+			break;
+
+		const float CosTheta = Shader.Type == Enums::Brdf ? AbsDot(Wi, SE.N) : 1.0f;
+
+		Throughput *= F * (CosTheta / Pdf);
+
+		if (Depth + 1 >= gpTracer->RenderSettings.Integrator.RussianRouletteDepth)
+		{
+			const float Survival = fminf(fmaxf(Throughput[0], fmaxf(Throughput[1], Throughput[2])), 0.95f);
+
+			if (!(RNG.Get1() < Survival))
+				break;
+
+			Throughput /= Survival;
+		}
+
+		LS.LargeStep(RNG);
+
+		SE = SampleRay(Ray(SE.P + Wi * RAY_EPS, Wi), RNG);
+	}
+
+	return ColorXYZAf(Lv[0], Lv[1], Lv[2], Valid ? 1.0f : 0.0f);
+}
+
+}
@@ -68,7 +68,7 @@ public:
 		if (Position < this->NodeRange[0])
 			return this->Value[0];
 
-		if (Position > this->NodeRange[1])
+		if (Position >= this->NodeRange[1])
 			return this->Value[this->Count - 1];
 
 		for (int i = 1; i < this->Count; i++)
@@ -84,6 +84,29 @@ public:
 
 		return 0.0f;
 	}
+
+	HOST_DEVICE Vec2f GetNodeRange() const
+	{
+		return this->NodeRange;
+	}
+
+	HOST_DEVICE int GetNoNodes() const
+	{
+		return this->Count;
+	}
+
+	HOST_DEVICE float Maximum(const float& Min, const float& Max) const
+	{
+		float Maximum = fmaxf(this->Evaluate(Min), this->Evaluate(Max));
+
+		for (int i = 0; i < this->Count; i++)
+		{
+			if (this->Position[i] > Min && this->Position[i] < Max)
+				Maximum = fmaxf(Maximum, this->Value[i]);
+		}
+
+		return Maximum;
+	}
 };
 
 }
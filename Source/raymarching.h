@@ -19,24 +19,188 @@
 #include "transferfunction.h"
 #include "shapes.h"
 #include "scatterevent.h"
+#include "clippingobjects.h"
 
 namespace ExposureRender
 {
 
-HOST_DEVICE_NI void SampleVolume(Ray R, CRNG& RNG, ScatterEvent& SE)
+HOST_DEVICE bool EmptyMacroCell(const Volume& Volume, const Vec3i& ID)
 {
-	float MinT;
-	float MaxT;
-	
+	const Vec2f Range = Volume.GetMacroCellRange(ID);
+
+	return gpTracer->Opacity1D.Maximum(Range[0], Range[1]) <= 0.0f;
+}
+
+HOST_DEVICE float MacroCellExitT(const Ray& R, const Volume& Volume, const Vec3i& ID)
+{
+	const Vec3f Min = Volume.BoundingBox.MinP + Vec3f((float)ID[0], (float)ID[1], (float)ID[2]) * Volume.MacroCellSize;
+	const Vec3f Max = Min + Volume.MacroCellSize;
+
+	float ExitT = FLT_MAX;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (R.D[i] > 0.0f)
+			ExitT = fminf(ExitT, (Max[i] - R.O[i]) / R.D[i]);
+
+		if (R.D[i] < 0.0f)
+			ExitT = fminf(ExitT, (Min[i] - R.O[i]) / R.D[i]);
+	}
+
+	return ExitT;
+}
+
+// Upper bound of the extinction in a macro cell, the density scale enters twice to match the fixed step marchers
+HOST_DEVICE float MacroCellMajorant(const Volume& Volume, const Vec3i& ID)
+{
+	const Vec2f Range = Volume.GetMacroCellRange(ID);
+
+	return gpTracer->RenderSettings.Shading.DensityScale * gpTracer->RenderSettings.Shading.DensityScale * gpTracer->Opacity1D.Maximum(Range[0], Range[1]);
+}
+
+// Streamed volumes load the brick one brick length further along the ray in the background, unless it is empty
+HOST_DEVICE void PrefetchAhead(const Volume& Volume, const Ray& R, const float& T, const float& MaxT)
+{
+	if (!Volume.IsStreamed())
+		return;
+
+	const float AheadT = T + BRICK_CACHE_BRICK_SIZE * Volume.MinStep;
+
+	if (AheadT < MaxT && !EmptyMacroCell(Volume, Volume.GetMacroCellID(R(AheadT))))
+		Volume.Prefetch(R(AheadT));
+}
+
+HOST_DEVICE float Extinction(const Vec3f& P)
+{
+	return gpTracer->RenderSettings.Shading.DensityScale * gpTracer->RenderSettings.Shading.DensityScale * gpTracer->Opacity1D.Evaluate(GetIntensity(gpTracer->VolumeSlot, P));
+}
+
+// Parts of the ray that lie inside the volume bounds and are not removed by a clipping object
+HOST_DEVICE bool GetMarchIntervals(const Ray& R, ClipIntervals& Intervals)
+{
+	const Volume& Volume = gpVolumes[gpTracer->VolumeSlot];
+
 	Intersection Int;
 
-	IntersectBox(R, gpVolumes[gpTracer->VolumeID].BoundingBox.MinP, gpVolumes[gpTracer->VolumeID].BoundingBox.MaxP, Int);
+	IntersectBox(R, Volume.BoundingBox.MinP, Volume.BoundingBox.MaxP, Int);
 
 	if (!Int.Valid)
+		return false;
+
+	Intervals = ClipIntervals(max(Int.NearT, R.MinT), min(Int.FarT, R.MaxT));
+
+	ClipRay(R, Intervals);
+
+	return Intervals.Count > 0;
+}
+
+HOST_DEVICE_NI void DeltaTracking(Ray R, CRNG& RNG, ScatterEvent& SE)
+{
+	const Volume& Volume = gpVolumes[gpTracer->VolumeSlot];
+
+	ClipIntervals Intervals;
+
+	if (!GetMarchIntervals(R, Intervals))
 		return;
 
-	MinT = max(Int.NearT, R.MinT);
-	MaxT = min(Int.FarT, R.MaxT);
+	for (int i = 0; i < Intervals.Count; i++)
+	{
+		const float MaxT = Intervals.MaxT[i];
+
+		float T = Intervals.MinT[i];
+
+		while (T < MaxT)
+		{
+			const Vec3i ID = Volume.GetMacroCellID(R(T + RAY_EPS));
+
+			const float ExitT		= min(max(MacroCellExitT(R, Volume, ID), T + RAY_EPS), MaxT);
+			const float Majorant	= MacroCellMajorant(Volume, ID);
+
+			if (Majorant > 0.0f)
+				PrefetchAhead(Volume, R, T, MaxT);
+
+			while (Majorant > 0.0f)
+			{
+				T -= logf(RNG.Get1()) / Majorant;
+
+				if (T >= ExitT)
+					break;
+
+				const Vec3f P = R(T);
+
+				if (RNG.Get1() * Majorant < Extinction(P))
+				{
+					SE.SetValid(T, P, NormalizedGradient(gpTracer->VolumeSlot, P), -R.D, ColorXYZf());
+					return;
+				}
+			}
+
+			T = ExitT;
+		}
+	}
+}
+
+HOST_DEVICE_NI float RatioTracking(Ray R, CRNG& RNG)
+{
+	const Volume& Volume = gpVolumes[gpTracer->VolumeSlot];
+
+	ClipIntervals Intervals;
+
+	if (!GetMarchIntervals(R, Intervals))
+		return 1.0f;
+
+	float Transmittance = 1.0f;
+
+	for (int i = 0; i < Intervals.Count && Transmittance > 0.0f; i++)
+	{
+		const float MaxT = Intervals.MaxT[i];
+
+		float T = Intervals.MinT[i];
+
+		while (T < MaxT && Transmittance > 0.0f)
+		{
+			const Vec3i ID = Volume.GetMacroCellID(R(T + RAY_EPS));
+
+			const float ExitT		= min(max(MacroCellExitT(R, Volume, ID), T + RAY_EPS), MaxT);
+			const float Majorant	= MacroCellMajorant(Volume, ID);
+
+			if (Majorant > 0.0f)
+				PrefetchAhead(Volume, R, T, MaxT);
+
+			while (Majorant > 0.0f)
+			{
+				T -= logf(RNG.Get1()) / Majorant;
+
+				if (T >= ExitT)
+					break;
+
+				Transmittance *= max(1.0f - Extinction(R(T)) / Majorant, 0.0f);
+			}
+
+			T = ExitT;
+		}
+	}
+
+	return Transmittance;
+}
+
+HOST_DEVICE_NI void SampleVolume(Ray R, CRNG& RNG, ScatterEvent& SE)
+{
+	if (gpTracer->RenderSettings.Traversal.Mode == Enums::DeltaTracking)
+	{
+		DeltaTracking(R, RNG, SE);
+		return;
+	}
+
+	ClipIntervals Intervals;
+
+	if (!GetMarchIntervals(R, Intervals))
+		return;
+
+	int IntervalID = 0;
+
+	float MinT = Intervals.MinT[0];
+	float MaxT = Intervals.MaxT[0];
 
 	const float S	= -log(RNG.Get1()) / gpTracer->RenderSettings.Shading.DensityScale;
 	float Sum		= 0.0f;
@@ -44,18 +208,48 @@ HOST_DEVICE_NI void SampleVolume(Ray R, CRNG& RNG, ScatterEvent& SE)
 
 	Vec3f Ps;
 
-	const float StepSize = gpTracer->RenderSettings.Traversal.StepFactorPrimary * gpVolumes[gpTracer->VolumeID].MinStep;
+	const float StepSize	= gpTracer->RenderSettings.Traversal.StepFactorPrimary * gpVolumes[gpTracer->VolumeSlot].MinStep;
+	const float Offset		= RNG.Get1() * StepSize;
+
+	MinT += Offset;
 
-	MinT += RNG.Get1() * StepSize;
+	const Volume& Volume = gpVolumes[gpTracer->VolumeSlot];
+
+	Vec3i MacroCellID(-1);
+	bool Empty = false;
 
 	while (Sum < S)
 	{
 		Ps = R.O + MinT * R.D;
 
 		if (MinT >= MaxT)
-			return;
+		{
+			if (++IntervalID >= Intervals.Count)
+				return;
+
+			MinT = Intervals.MinT[IntervalID] + Offset;
+			MaxT = Intervals.MaxT[IntervalID];
+			continue;
+		}
 		
-		float Intensity = GetIntensity(gpTracer->VolumeID, Ps);
+		const Vec3i ID = Volume.GetMacroCellID(Ps);
+
+		if (ID != MacroCellID)
+		{
+			MacroCellID	= ID;
+			Empty		= EmptyMacroCell(Volume, ID);
+
+			if (!Empty)
+				PrefetchAhead(Volume, R, MinT, MaxT);
+		}
+
+		if (Empty)
+		{
+			MinT += max(ceilf((MacroCellExitT(R, Volume, ID) - MinT) / StepSize), 1.0f) * StepSize;
+			continue;
+		}
+
+		float Intensity = GetIntensity(gpTracer->VolumeSlot, Ps);
 
 		SigmaT	= gpTracer->RenderSettings.Shading.DensityScale * gpTracer->Opacity1D.Evaluate(Intensity);
 
@@ -63,209 +257,77 @@ HOST_DEVICE_NI void SampleVolume(Ray R, CRNG& RNG, ScatterEvent& SE)
 		MinT	+= StepSize;
 	}
 
-	SE.SetValid(MinT, Ps, NormalizedGradient(gpTracer->VolumeID, Ps), -R.D, ColorXYZf());
+	SE.SetValid(MinT, Ps, NormalizedGradient(gpTracer->VolumeSlot, Ps), -R.D, ColorXYZf());
 }
 
 HOST_DEVICE_NI bool ScatterEventInVolume(Ray R, CRNG& RNG)
 {
-	float MinT;
-	float MaxT;
 	Vec3f Ps;
 
-	Intersection Int;
-		
-	IntersectBox(R, gpVolumes[gpTracer->VolumeID].BoundingBox.MinP, gpVolumes[gpTracer->VolumeID].BoundingBox.MaxP, Int);
-	
-	if (!Int.Valid)
+	ClipIntervals Intervals;
+
+	if (!GetMarchIntervals(R, Intervals))
 		return false;
 
-	MinT = max(Int.NearT, R.MinT);
-	MaxT = min(Int.FarT, R.MaxT);
+	int IntervalID = 0;
+
+	float MinT = Intervals.MinT[0];
+	float MaxT = Intervals.MaxT[0];
 
 	const float S	= -log(RNG.Get1()) / gpTracer->RenderSettings.Shading.DensityScale;
 	float Sum		= 0.0f;
 	float SigmaT	= 0.0f;
 
-	const float StepSize = gpTracer->RenderSettings.Traversal.StepFactorShadow * gpVolumes[gpTracer->VolumeID].MinStep;
+	const float StepSize	= gpTracer->RenderSettings.Traversal.StepFactorShadow * gpVolumes[gpTracer->VolumeSlot].MinStep;
+	const float Offset		= RNG.Get1() * StepSize;
+
+	MinT += Offset;
 
-	MinT += RNG.Get1() * StepSize;
+	const Volume& Volume = gpVolumes[gpTracer->VolumeSlot];
+
+	Vec3i MacroCellID(-1);
+	bool Empty = false;
 
 	while (Sum < S)
 	{
 		Ps = R.O + MinT * R.D;
 
 		if (MinT > MaxT)
-			return false;
+		{
+			if (++IntervalID >= Intervals.Count)
+				return false;
+
+			MinT = Intervals.MinT[IntervalID] + Offset;
+			MaxT = Intervals.MaxT[IntervalID];
+			continue;
+		}
 		
-		float Intensity = GetIntensity(gpTracer->VolumeID, Ps);
-
-		SigmaT	= gpTracer->RenderSettings.Shading.DensityScale * gpTracer->Opacity1D.Evaluate(Intensity);
-
-		Sum		+= SigmaT * StepSize;
-		MinT	+= StepSize;
-	}
+		const Vec3i ID = Volume.GetMacroCellID(Ps);
 
-	return true;
-}
+		if (ID != MacroCellID)
+		{
+			MacroCellID	= ID;
+			Empty		= EmptyMacroCell(Volume, ID);
 
-/*
-struct Photon{
-  Vec3f origin;
-  Vec3f direction;
-  float energy;
-
-  // gamma photon
-  float photonEnergy;
-  float sigma;
-};
-
-#define EPS (0.000001f)
-
-__device__
-float sign(float num){
-  if(num<0.0f) return(-1.0f);
-  if(num>0.0f) return(1.0f);
-  return(0.0f);
-}
+			if (!Empty)
+				PrefetchAhead(Volume, R, MinT, MaxT);
+		}
 
+		if (Empty)
+		{
+			MinT += max(ceilf((MacroCellExitT(R, Volume, ID) - MinT) / StepSize), 1.0f) * StepSize;
+			continue;
+		}
 
-HOST_DEVICE void lightShootDDAWoodcock(const Ray& R, CRNG& RNG, ScatterEvent& SE)
-{
-	Intersection Int;
+		float Intensity = GetIntensity(gpTracer->VolumeSlot, Ps);
 
-	IntersectBox(R, ToVec3f(gVolumeProperties.MinAABB), ToVec3f(gVolumeProperties.MaxAABB), Int);
+		SigmaT	= gpTracer->RenderSettings.Shading.DensityScale * gpTracer->Opacity1D.Evaluate(Intensity);
 
-	if (!Int.Valid)
-		return;
-	else
-	{
-//		SE.SetValid((R(Int.NearT) - R.O).Length(), R(Int.NearT), NormalizedGradient(R(Int.NearT)), -R.D, ColorXYZf());
-//		return;
+		Sum		+= SigmaT * StepSize;
+		MinT	+= StepSize;
 	}
 
-	Photon photon;
-
-	photon.origin = R(Int.NearT + 0.000001f);
-	photon.direction = R.D;
-
-	float c_macrocellSize = 1.0f / 8.0f;
-
-  Vec3f cellIndex;
-  cellIndex[0] = floor(photon.origin[0] / c_macrocellSize);
-  cellIndex[1] = floor(photon.origin[1] / c_macrocellSize);
-  cellIndex[2] = floor(photon.origin[2] / c_macrocellSize);
-  
-  Vec3f t(0.0f);
-
-  if(photon.direction[0] > EPS){
-    t[0] = ((cellIndex[0] + 1) * c_macrocellSize - photon.origin[0]) / photon.direction[0];
-  } else {
-    if(photon.direction[0] < -EPS){
-      t[0] = (cellIndex[0] * c_macrocellSize - photon.origin[0]) / photon.direction[0];
-    } else {
-      t[0] = 1000.0f;
-    }
-  }
-  if(photon.direction[1] > EPS){
-    t[1] = ((cellIndex[1] + 1) * c_macrocellSize - photon.origin[1]) / photon.direction[1];
-  } else {
-    if(photon.direction[1] < -EPS){
-      t[1] = (cellIndex[1] * c_macrocellSize - photon.origin[1]) / photon.direction[1];
-    } else {
-      t[1] = 1000.0f;
-    }
-  }
-  if(photon.direction[2] > EPS){
-    t[2] = ((cellIndex[2] + 1) * c_macrocellSize - photon.origin[2]) / photon.direction[2];
-  } else {
-    if(photon.direction[2] < -EPS){
-      t[2] = (cellIndex[2] * c_macrocellSize - photon.origin[2]) / photon.direction[2];
-    } else {
-      t[2] = 1000.0f;
-    }
-  }
-
-  Vec3f cpv;
-  cpv[0] = c_macrocellSize / fabs(photon.direction[0]);
-  cpv[1] = c_macrocellSize / fabs(photon.direction[1]);
-  cpv[2] = c_macrocellSize / fabs(photon.direction[2]);
-
-  Vec3f samplePos = photon.origin;
-
-  int steps = 0;
-  
-  float c_densityScale = gVolumeProperties.DensityScale;
-
-  bool virtualHit = true;
-  while(virtualHit) {
-    float sigmaMax = tex3D(gTexExtinction, photon.origin[0], photon.origin[1], photon.origin[2]);
-    float lastSigmaMax = sigmaMax;
-    float ds = min(t[0], min(t[1], t[2]));
-    float sigmaSum = sigmaMax * ds;
-	float s = -log(1.0f - RNG.Get1()) / c_densityScale;
-    float tt = min(t[0], min(t[1], t[2]));
-    Vec3f entry;
-    Vec3f exit = photon.origin + tt * photon.direction;
-
-    while(sigmaSum < s){
-      if(steps++ > 100.0f){
-        photon.energy = 0.0f;
-        return;
-      }
-      entry = exit;
-
-      if (entry[0] <= -0.5f || entry[0] >= 0.5f ||
-          entry[1] <= -0.5f || entry[1] >= 0.5f ||
-          entry[2] <= -0.5f || entry[2] >= 0.5f){
-        photon.energy = 0.0f;
-        return;
-      }
-
-      if(t[0]<t[1] && t[0]<t[2]){
-        cellIndex[0] += sign(photon.direction[0]);
-        t[0] += cpv[0];
-      } else {
-        if(t[1]<t[0] && t[1]<t[2]){
-          cellIndex[1] += sign(photon.direction[1]);
-          t[1] += cpv[1];
-        } else {
-          cellIndex[2] += sign(photon.direction[2]);
-          t[2] += cpv[2];
-        }
-      }
-
-      tt = min(t[0], min(t[1], t[2]));
-      exit = photon.origin + tt * photon.direction;
-      ds = (exit-entry).Length();
-      sigmaSum += ds * sigmaMax;
-      lastSigmaMax = sigmaMax;
-      Vec3f ePos = (exit + entry) / 2.0f;
-      sigmaMax = tex3D(gTexExtinction, ePos[0], ePos[1], ePos[2]);
-      samplePos = entry;
-    }
-
-    float cS = (s - (sigmaSum - ds * lastSigmaMax)) / lastSigmaMax;
-    samplePos += photon.direction * cS;
-
-    if (photon.origin[0] <= -0.5f || photon.origin[0] >= 0.5f ||
-        photon.origin[1] <= -0.5f || photon.origin[1] >= 0.5f ||
-        photon.origin[2] <= -0.5f || photon.origin[2] >= 0.5f){
-      photon.energy = 0.0f;
-      return;
-    }
-
-	if(tex3D(gTexIntensity, samplePos[0], samplePos[1], samplePos[2]) / tex3D(gTexExtinction, samplePos[0], samplePos[1], samplePos[2]) > RNG.Get1()){
-      virtualHit = false;
-    } else {
-      photon.origin = exit;
-    }
-  }
-
-//  photon.energy = photon.energy * c_albedo;
-//  photon.origin = samplePos;
-
-	SE.SetValid((samplePos - R.O).Length(), samplePos, NormalizedGradient(samplePos), -R.D, ColorXYZf());
+	return true;
 }
-*/
 
 }
\ No newline at end of file
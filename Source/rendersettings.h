@@ -27,6 +27,7 @@ public:
 	public:
 		HOST TraversalSettings()
 		{
+			this->Mode				= 0;
 			this->StepFactorPrimary	= 0.1f;
 			this->StepFactorShadow	= 0.1f;
 			this->Shadows			= true;
@@ -44,6 +45,7 @@ public:
 
 		HOST TraversalSettings& operator = (const TraversalSettings& Other)
 		{
+			this->Mode					= Other.Mode;
 			this->StepFactorPrimary		= Other.StepFactorPrimary;
 			this->StepFactorShadow		= Other.StepFactorShadow;
 			this->Shadows				= Other.Shadows;
@@ -52,6 +54,7 @@ public:
 			return *this;
 		}
 
+		int		Mode;
 		float	StepFactorPrimary;
 		float	StepFactorShadow;
 		bool	Shadows;
@@ -69,6 +72,8 @@ public:
 			this->GradientComputation	= 1;
 			this->GradientThreshold		= 0.5f;
 			this->GradientFactor		= 0.5f;
+			this->TransferFunctionResolution	= 512;
+			this->LightingStrategy		= 2;
 		}
 
 		HOST ~ShadingSettings()
@@ -88,6 +93,8 @@ public:
 			this->GradientComputation	= Other.GradientComputation;
 			this->GradientThreshold		= Other.GradientThreshold;
 			this->GradientFactor		= Other.GradientFactor;
+			this->TransferFunctionResolution	= Other.TransferFunctionResolution;
+			this->LightingStrategy		= Other.LightingStrategy;
 
 			return *this;
 		}
@@ -98,6 +105,104 @@ public:
 		int		GradientComputation;
 		float	GradientThreshold;
 		float	GradientFactor;
+		int		TransferFunctionResolution;
+		int		LightingStrategy;
+	};
+
+	class EXPOSURE_RENDER_DLL SamplingSettings
+	{
+	public:
+		HOST SamplingSettings()
+		{
+			this->Type					= 0;
+			this->AdaptiveThreshold		= 0.0f;
+			this->AdaptiveMinSamples	= 32;
+		}
+
+		HOST ~SamplingSettings()
+		{
+		}
+		
+		HOST SamplingSettings(const SamplingSettings& Other)
+		{
+			*this = Other;
+		}
+
+		HOST SamplingSettings& operator = (const SamplingSettings& Other)
+		{
+			this->Type					= Other.Type;
+			this->AdaptiveThreshold		= Other.AdaptiveThreshold;
+			this->AdaptiveMinSamples	= Other.AdaptiveMinSamples;
+
+			return *this;
+		}
+
+		int		Type;
+		float	AdaptiveThreshold;
+		int		AdaptiveMinSamples;
+	};
+
+	class EXPOSURE_RENDER_DLL IntegratorSettings
+	{
+	public:
+		HOST IntegratorSettings()
+		{
+			this->Type					= 0;
+			this->MaxDepth				= 4;
+			this->RussianRouletteDepth	= 2;
+		}
+
+		HOST ~IntegratorSettings()
+		{
+		}
+		
+		HOST IntegratorSettings(const IntegratorSettings& Other)
+		{
+			*this = Other;
+		}
+
+		HOST IntegratorSettings& operator = (const IntegratorSettings& Other)
+		{
+			this->Type					= Other.Type;
+			this->MaxDepth				= Other.MaxDepth;
+			this->RussianRouletteDepth	= Other.RussianRouletteDepth;
+
+			return *this;
+		}
+
+		int		Type;
+		int		MaxDepth;
+		int		RussianRouletteDepth;
+	};
+
+	class EXPOSURE_RENDER_DLL ThreadingSettings
+	{
+	public:
+		HOST ThreadingSettings()
+		{
+			this->NoThreads	= 0;
+			this->TileSize	= 16;
+		}
+
+		HOST ~ThreadingSettings()
+		{
+		}
+		
+		HOST ThreadingSettings(const ThreadingSettings& Other)
+		{
+			*this = Other;
+		}
+
+		HOST ThreadingSettings& operator = (const ThreadingSettings& Other)
+		{
+			this->NoThreads	= Other.NoThreads;
+			this->TileSize	= Other.TileSize;
+
+			return *this;
+		}
+
+		int		NoThreads;
+		int		TileSize;
 	};
 
 	HOST RenderSettings()
@@ -117,12 +222,18 @@ public:
 	{
 		this->Traversal		= Other.Traversal;
 		this->Shading		= Other.Shading;
+		this->Sampling		= Other.Sampling;
+		this->Integrator	= Other.Integrator;
+		this->Threading		= Other.Threading;
 
 		return *this;
 	}
 
 	TraversalSettings	Traversal;
 	ShadingSettings		Shading;
+	SamplingSettings	Sampling;
+	IntegratorSettings	Integrator;
+	ThreadingSettings	Threading;
 };
 
 }
@@ -18,46 +18,74 @@
 namespace ExposureRender
 {
 
+// Counter based Philox 2x32-10 generator keyed by stream and iteration, nothing is stored between samples
 class CRNG
 {
 public:
-	HOST_DEVICE CRNG(unsigned int* pSeed0, unsigned int* pSeed1)
+	HOST_DEVICE CRNG(const unsigned int& Stream, const unsigned int& Iteration) :
+		Stream(Stream),
+		Iteration(Iteration),
+		Counter(0)
 	{
-		this->pSeed0 = pSeed0;
-		this->pSeed1 = pSeed1;
 	}
 
 	HOST_DEVICE float Get1(void)
 	{
-		*this->pSeed0 = 36969 * ((*pSeed0) & 65535) + ((*pSeed0) >> 16);
-		*this->pSeed1 = 18000 * ((*pSeed1) & 65535) + ((*pSeed1) >> 16);
+		unsigned int R[2];
 
-		unsigned int ires = ((*pSeed0) << 16) + (*pSeed1);
+		this->Next(R);
 
-		union
-		{
-			float f;
-			unsigned int ui;
-		} res;
-
-		res.ui = (ires & 0x007fffff) | 0x40000000;
-
-		return (res.f - 2.f) / 2.f;
+		return ToFloat(R[0]);
 	}
 
 	HOST_DEVICE Vec2f Get2(void)
 	{
-		return Vec2f(Get1(), Get1());
+		unsigned int R[2];
+
+		this->Next(R);
+
+		return Vec2f(ToFloat(R[0]), ToFloat(R[1]));
 	}
 
 	HOST_DEVICE Vec3f Get3(void)
 	{
-		return Vec3f(Get1(), Get1(), Get1());
+		const Vec2f R = Get2();
+
+		return Vec3f(R[0], R[1], Get1());
 	}
 
 private:
-	unsigned int*	pSeed0;
-	unsigned int*	pSeed1;
+	HOST_DEVICE void Next(unsigned int R[2])
+	{
+		R[0] = this->Counter++;
+		R[1] = this->Stream;
+
+		unsigned int Key = this->Iteration;
+
+		for (int i = 0; i < 10; i++)
+		{
+#ifdef __CUDA_ARCH__
+			const unsigned int Hi = __umulhi(0xD256D193u, R[0]);
+#else
+			const unsigned int Hi = (unsigned int)(((unsigned long long)0xD256D193u * R[0]) >> 32);
+#endif
+			const unsigned int Lo = 0xD256D193u * R[0];
+
+			R[0] = Hi ^ Key ^ R[1];
+			R[1] = Lo;
+
+			Key += 0x9E3779B9u;
+		}
+	}
+
+	HOST_DEVICE static float ToFloat(const unsigned int& R)
+	{
+		return (float)(R >> 8) * (1.0f / 16777216.0f);
+	}
+
+	unsigned int	Stream;
+	unsigned int	Iteration;
+	unsigned int	Counter;
 };
 
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "geometry.h"
 #include "color.h"
 #include "rng.h"
+#include "sampler.h"
 
 namespace ExposureRender
 {
@@ -93,9 +94,10 @@ public:
 		return *this;
 	}
 
-	HOST_DEVICE void LargeStep(CRNG& RNG)
+	template<class T>
+	HOST_DEVICE void LargeStep(T& Sampler)
 	{
-		this->SurfaceUVW = RNG.Get3();
+		this->SurfaceUVW = Sampler.Get3();
 	}
 
 	HOST_DEVICE void Mutate(CRNG& RNG)
@@ -134,10 +136,11 @@ public:
 		return *this;
 	}
 
-	HOST_DEVICE void LargeStep(CRNG& RNG)
+	template<class T>
+	HOST_DEVICE void LargeStep(T& Sampler)
 	{
-		this->Component	= RNG.Get1();
-		this->Dir		= RNG.Get2();
+		this->Component	= Sampler.Get1();
+		this->Dir		= Sampler.Get2();
 	}
 
 	HOST_DEVICE void Mutate(CRNG& RNG)
@@ -172,11 +175,12 @@ public:
 		return *this;
 	}
 
-	HOST_DEVICE void LargeStep(CRNG& RNG)
+	template<class T>
+	HOST_DEVICE void LargeStep(T& Sampler)
 	{
-		this->BrdfSample.LargeStep(RNG);
-		this->LightSample.LargeStep(RNG);
-		this->LightNum = RNG.Get1();
+		this->BrdfSample.LargeStep(Sampler);
+		this->LightSample.LargeStep(Sampler);
+		this->LightNum = Sampler.Get1();
 	}
 
 	HOST_DEVICE void Mutate(CRNG& RNG)
@@ -213,10 +217,11 @@ public:
 		return *this;
 	}
 
-	HOST_DEVICE void LargeStep(CRNG& RNG)
+	template<class T>
+	HOST_DEVICE void LargeStep(T& Sampler)
 	{
-		this->FilmUV	= RNG.Get2();
-		this->LensUV	= RNG.Get2();
+		this->FilmUV	= Sampler.Get2();
+		this->LensUV	= Sampler.Get2();
 	}
 
 	HOST_DEVICE void Mutate(CRNG& RNG)
@@ -250,10 +255,11 @@ public:
 		return *this;
 	}
 
-	HOST_DEVICE void LargeStep(CRNG& RNG)
+	template<class T>
+	HOST_DEVICE void LargeStep(T& Sampler)
 	{
-		this->LightingSample.LargeStep(RNG);
-		this->CameraSample.LargeStep(RNG);
+		this->LightingSample.LargeStep(Sampler);
+		this->CameraSample.LargeStep(Sampler);
 	}
 
 	HOST_DEVICE MetroSample Mutate(CRNG& RNG)
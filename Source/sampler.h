@@ -0,0 +1,122 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+	
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "geometry.h"
+
+namespace ExposureRender
+{
+
+// Owen scrambled Sobol points (Burley 2020), consecutive dimension pairs are padded by shuffling the sample index per pair
+class SobolSampler
+{
+public:
+	HOST_DEVICE SobolSampler(const unsigned int& Stream, const unsigned int& Index) :
+		Seed(Hash(Stream)),
+		Index(Index),
+		Dimension(0)
+	{
+	}
+
+	HOST_DEVICE float Get1(void)
+	{
+		const unsigned int DimensionSeed = Hash(this->Seed ^ Hash(this->Dimension++));
+		const unsigned int Index = NestedUniformScramble(this->Index, DimensionSeed);
+
+		return ToFloat(NestedUniformScramble(ReverseBits(Index), Hash(DimensionSeed)));
+	}
+
+	HOST_DEVICE Vec2f Get2(void)
+	{
+		const unsigned int DimensionSeed = Hash(this->Seed ^ Hash(this->Dimension));
+		const unsigned int Index = NestedUniformScramble(this->Index, DimensionSeed);
+
+		this->Dimension += 2;
+
+		return Vec2f(ToFloat(NestedUniformScramble(ReverseBits(Index), Hash(DimensionSeed ^ 0x1B56C4E9u))), ToFloat(NestedUniformScramble(Sobol1(Index), Hash(DimensionSeed ^ 0x7F4A7C15u))));
+	}
+
+	HOST_DEVICE Vec3f Get3(void)
+	{
+		const Vec2f UV = this->Get2();
+
+		return Vec3f(UV[0], UV[1], this->Get1());
+	}
+
+private:
+	HOST_DEVICE static unsigned int ReverseBits(unsigned int X)
+	{
+#ifdef __CUDA_ARCH__
+		return __brev(X);
+#else
+		X = ((X >> 1) & 0x55555555u) | ((X & 0x55555555u) << 1);
+		X = ((X >> 2) & 0x33333333u) | ((X & 0x33333333u) << 2);
+		X = ((X >> 4) & 0x0F0F0F0Fu) | ((X & 0x0F0F0F0Fu) << 4);
+		X = ((X >> 8) & 0x00FF00FFu) | ((X & 0x00FF00FFu) << 8);
+
+		return (X >> 16) | (X << 16);
+#endif
+	}
+
+	HOST_DEVICE static unsigned int Sobol1(unsigned int Index)
+	{
+		unsigned int Result = 0;
+
+		for (unsigned int V = 1u << 31; Index; Index >>= 1, V ^= V >> 1)
+		{
+			if (Index & 1)
+				Result ^= V;
+		}
+
+		return Result;
+	}
+
+	HOST_DEVICE static unsigned int LaineKarrasPermutation(unsigned int X, const unsigned int& Seed)
+	{
+		X += Seed;
+		X ^= X * 0x6C50B47Cu;
+		X ^= X * 0xB82F1E52u;
+		X ^= X * 0xC7AFE638u;
+		X ^= X * 0x8D22F6E6u;
+
+		return X;
+	}
+
+	HOST_DEVICE static unsigned int NestedUniformScramble(const unsigned int& X, const unsigned int& Seed)
+	{
+		return ReverseBits(LaineKarrasPermutation(ReverseBits(X), Seed));
+	}
+
+	HOST_DEVICE static unsigned int Hash(unsigned int X)
+	{
+		X ^= X >> 16;
+		X *= 0x7FEB352Du;
+		X ^= X >> 15;
+		X *= 0x846CA68Bu;
+		X ^= X >> 16;
+
+		return X;
+	}
+
+	HOST_DEVICE static float ToFloat(const unsigned int& X)
+	{
+		return (float)(X >> 8) * (1.0f / 16777216.0f);
+	}
+
+	unsigned int	Seed;
+	unsigned int	Index;
+	unsigned int	Dimension;
+};
+
+}
@@ -282,7 +282,7 @@ public:
 
 	HOST_DEVICE ColorXYZf F(const Vec3f& Wo, const Vec3f& Wi)
 	{
-		return Kd * INV_PI_F;
+		return Kd * INV_FOUR_PI_F;
 	}
 
 	HOST_DEVICE ColorXYZf SampleF(const Vec3f& Wo, Vec3f& Wi, float& Pdf, const Vec2f& U)
@@ -365,8 +365,7 @@ public:
 			this->Microfacet.SampleF(Wol, Wil, Pdf, S.Dir);
 		}
 
-		Pdf += this->Lambertian.Pdf(Wol, Wil);
-		Pdf += this->Microfacet.Pdf(Wol, Wil);
+		Pdf = 0.5f * (this->Lambertian.Pdf(Wol, Wil) + this->Microfacet.Pdf(Wol, Wil));
 
 		R += this->Lambertian.F(Wol, Wil);
 		R += this->Microfacet.F(Wol, Wil);
@@ -381,12 +380,8 @@ public:
 		const Vec3f Wol = WorldToLocal(Wo);
 		const Vec3f Wil = WorldToLocal(Wi);
 
-		float Pdf = 0.0f;
-
-		Pdf += this->Lambertian.Pdf(Wol, Wil);
-		Pdf += this->Microfacet.Pdf(Wol, Wil);
-
-		return Pdf;
+		// Both lobes are picked with equal probability in SampleF
+		return 0.5f * (this->Lambertian.Pdf(Wol, Wil) + this->Microfacet.Pdf(Wol, Wil));
 	}
 
 	HOST_DEVICE BRDF& operator = (const BRDF& Other)
@@ -0,0 +1,157 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or witDEVut modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software witDEVut specific prior written permission.
+	
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT DEVLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT DEVLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) DEVWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "ertracer.h"
+#include "utilities.h"
+
+namespace ExposureRender
+{
+
+class ShadingLUT
+{
+public:
+	// Aligned so the two records of a lookup span exactly two cache lines
+	class ALIGN(64) Record
+	{
+	public:
+		HOST_DEVICE Record() :
+			Diffuse(),
+			Specular(),
+			Emission(),
+			Exponent(0.0f)
+		{
+		}
+
+		HOST_DEVICE Record(const Record& Other)
+		{
+			*this = Other;
+		}
+
+		HOST_DEVICE Record& operator = (const Record& Other)
+		{
+			this->Diffuse	= Other.Diffuse;
+			this->Specular	= Other.Specular;
+			this->Emission	= Other.Emission;
+			this->Exponent	= Other.Exponent;
+
+			return *this;
+		}
+
+		ColorXYZf	Diffuse;
+		ColorXYZf	Specular;
+		ColorXYZf	Emission;
+		float		Exponent;
+	};
+
+	HOST ShadingLUT() :
+		Size(0),
+		Range(0.0f),
+		Scale(0.0f)
+	{
+	}
+
+	HOST ~ShadingLUT()
+	{
+	}
+
+	HOST ShadingLUT(const ShadingLUT& Other)
+	{
+		*this = Other;
+	}
+
+	HOST ShadingLUT& operator = (const ShadingLUT& Other)
+	{
+		this->Size	= Other.Size;
+		this->Range	= Other.Range;
+		this->Scale	= Other.Scale;
+
+		for (int i = 0; i < this->Size; i++)
+			this->Records[i] = Other.Records[i];
+
+		return *this;
+	}
+
+	HOST void Build(const ErTracer& Tracer, const int& Resolution)
+	{
+		this->Size	= 0;
+		this->Range	= Vec2f(FLT_MAX, -FLT_MAX);
+
+		this->Include(Tracer.Glossiness1D.PLF);
+
+		for (int i = 0; i < 3; i++)
+		{
+			this->Include(Tracer.Diffuse1D.PLF[i]);
+			this->Include(Tracer.Specular1D.PLF[i]);
+			this->Include(Tracer.Emission1D.PLF[i]);
+		}
+
+		if (this->Range[0] > this->Range[1] || Resolution < 2)
+			return;
+
+		this->Size = min(Resolution, MAX_TF_LUT_SIZE);
+
+		const float Extent = this->Range[1] - this->Range[0];
+
+		this->Scale = Extent > 0.0f ? (float)(this->Size - 1) / Extent : 0.0f;
+
+		for (int i = 0; i < this->Size; i++)
+			Evaluate(Tracer, this->Range[0] + Extent * ((float)i / (float)(this->Size - 1)), this->Records[i]);
+	}
+
+	HOST_DEVICE bool Lookup(const float& Intensity, Record& Shading) const
+	{
+		if (this->Size <= 0)
+			return false;
+
+		const float U = Clamp((Intensity - this->Range[0]) * this->Scale, 0.0f, (float)(this->Size - 1));
+		const int I = min((int)U, this->Size - 2);
+		const float T = U - (float)I;
+
+		const Record& A = this->Records[I];
+		const Record& B = this->Records[I + 1];
+
+		Shading.Diffuse		= ColorXYZf(A.Diffuse[0] + T * (B.Diffuse[0] - A.Diffuse[0]), A.Diffuse[1] + T * (B.Diffuse[1] - A.Diffuse[1]), A.Diffuse[2] + T * (B.Diffuse[2] - A.Diffuse[2]));
+		Shading.Specular	= ColorXYZf(A.Specular[0] + T * (B.Specular[0] - A.Specular[0]), A.Specular[1] + T * (B.Specular[1] - A.Specular[1]), A.Specular[2] + T * (B.Specular[2] - A.Specular[2]));
+		Shading.Emission		= ColorXYZf(A.Emission[0] + T * (B.Emission[0] - A.Emission[0]), A.Emission[1] + T * (B.Emission[1] - A.Emission[1]), A.Emission[2] + T * (B.Emission[2] - A.Emission[2]));
+		Shading.Exponent		= A.Exponent + T * (B.Exponent - A.Exponent);
+
+		return true;
+	}
+
+	HOST_DEVICE static void Evaluate(const ErTracer& Tracer, const float& Intensity, Record& Shading)
+	{
+		Shading.Diffuse		= Tracer.Diffuse1D.Evaluate(Intensity);
+		Shading.Specular	= Tracer.Specular1D.Evaluate(Intensity);
+		Shading.Emission		= Tracer.Emission1D.Evaluate(Intensity);
+		Shading.Exponent		= GlossinessExponent(Tracer.Glossiness1D.Evaluate(Intensity));
+	}
+
+private:
+	HOST void Include(const PiecewiseLinearFunction<MAX_NO_TF_NODES>& PLF)
+	{
+		if (PLF.GetNoNodes() <= 0)
+			return;
+
+		this->Range[0] = fminf(this->Range[0], PLF.GetNodeRange()[0]);
+		this->Range[1] = fmaxf(this->Range[1], PLF.GetNodeRange()[1]);
+	}
+
+	Record	Records[MAX_TF_LUT_SIZE];
+	int		Size;
+	Vec2f	Range;
+	float	Scale;
+};
+
+}
@@ -19,6 +19,7 @@
 #include "box.h"
 #include "sphere.h"
 #include "cylinder.h"
+#include "boundingbox.h"
 
 namespace ExposureRender
 {
@@ -66,4 +67,31 @@ HOST_DEVICE bool IntersectsShape(const Shape& Shape, const Ray& R)
 	return Intersection.Valid;
 }
 
+HOST_DEVICE BoundingBox GetBoundingBox(const Shape& Shape)
+{
+	Vec3f HalfSize;
+
+	switch (Shape.Type)
+	{
+		case Enums::Plane:		HalfSize = Vec3f(0.5f * Shape.Size[0], 0.5f * Shape.Size[1], 0.0f);	break;
+		case Enums::Disk:
+		case Enums::Ring:		HalfSize = Vec3f(Shape.OuterRadius, Shape.OuterRadius, 0.0f);		break;
+		case Enums::Box:		HalfSize = 0.5f * Shape.Size;										break;
+		case Enums::Sphere:		HalfSize = Vec3f(Shape.OuterRadius);								break;
+		default:				return BoundingBox(Vec3f(-FLT_MAX), Vec3f(FLT_MAX));
+	}
+
+	Vec3f MinP(FLT_MAX), MaxP(-FLT_MAX);
+
+	for (int i = 0; i < 8; i++)
+	{
+		const Vec3f P = TransformPoint(Shape.TM, Vec3f(i & 1 ? HalfSize[0] : -HalfSize[0], i & 2 ? HalfSize[1] : -HalfSize[1], i & 4 ? HalfSize[2] : -HalfSize[2]));
+
+		MinP = MinP.Min(P);
+		MaxP = MaxP.Max(P);
+	}
+
+	return BoundingBox(MinP, MaxP);
+}
+
 }
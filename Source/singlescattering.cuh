@@ -32,4 +32,21 @@ void SingleScattering(Tracer& Tracer)
 	LAUNCH_CUDA_KERNEL_TIMED((KrnlSingleScattering<<<GridDim, BlockDim>>>()), "Single Scattering"); 
 }
 
+namespace Host
+{
+
+void SingleScattering(Tracer& Tracer)
+{
+	ScopedTiming Timing(gpTimings, "Single Scattering");
+
+	gTileScheduler.Run(gThreadPool, Tracer.FrameBuffer.Resolution, Tracer.RenderSettings.Threading.TileSize, Tracer.FrameBuffer.TileTimings, [&](const Vec2i& Min, const Vec2i& Max)
+	{
+		for (int Y = Min[1]; Y < Max[1]; Y++)
+			for (int X = Min[0]; X < Max[0]; X++)
+				Tracer.FrameBuffer.FrameEstimate(X, Y) = ExposureRender::SingleScattering(&Tracer, Vec2i(X, Y));
+	});
+}
+
+}
+
 }
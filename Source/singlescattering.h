@@ -68,17 +68,59 @@ HOST_DEVICE_NI ScatterEvent SampleRay(Ray R, CRNG& RNG)
 	return NearestRS;
 }
 
+// Statistics are taken from the unfiltered samples, the frame filter averages neighbours and would hide most of the per-pixel variance
+HOST_DEVICE_NI bool Converged(const Vec4f& Statistics, const int& NoSamples)
+{
+	const float& Threshold = gpTracer->RenderSettings.Sampling.AdaptiveThreshold;
+
+	if (Threshold <= 0.0f || gpTracer->NoIterations == 0)
+		return false;
+
+	if (NoSamples < max(gpTracer->RenderSettings.Sampling.AdaptiveMinSamples, 2))
+		return false;
+
+	// Standard error of the luminance relative to its mean, and of the coverage
+	const float ErrorY = sqrtf(fmaxf(Statistics[1] - Statistics[0] * Statistics[0], 0.0f) / (float)NoSamples) / fmaxf(Statistics[0], 0.001f);
+	const float ErrorA = sqrtf(fmaxf(Statistics[3] - Statistics[2] * Statistics[2], 0.0f) / (float)NoSamples);
+
+	return ErrorY < Threshold && ErrorA < Threshold;
+}
+
+HOST_DEVICE_NI bool Converged(const int& X, const int& Y)
+{
+	return Converged(gpTracer->FrameBuffer.RunningStatistics(X, Y), gpTracer->FrameBuffer.NoSamples(X, Y));
+}
+
+HOST_DEVICE_NI void SamplePixel(const Vec2i& PixelCoord, CRNG& RNG, MetroSample& Sample, Ray& R)
+{
+	if (gpTracer->RenderSettings.Sampling.Type == Enums::Sobol)
+	{
+		SobolSampler Sampler(PixelCoord[1] * gpTracer->FrameBuffer.Resolution[0] + PixelCoord[0], gpTracer->NoIterations);
+		Sample.LargeStep(Sampler);
+	}
+	else
+	{
+		Sample.LargeStep(RNG);
+	}
+
+	SampleCamera(gpTracer->Camera, R, PixelCoord[0], PixelCoord[1], Sample.CameraSample);
+}
+
 HOST_DEVICE_NI ColorXYZAf SingleScattering(Tracer* pTracer, const Vec2i& PixelCoord)
 {
-	CRNG RNG(&gpTracer->FrameBuffer.RandomSeeds1(PixelCoord[0], PixelCoord[1]), &gpTracer->FrameBuffer.RandomSeeds2(PixelCoord[0], PixelCoord[1]));
+	// Converged pixels hand their running estimate to the frame filter instead of tracing a new sample
+	if (Converged(PixelCoord[0], PixelCoord[1]))
+		return gpTracer->FrameBuffer.RunningEstimateXyza(PixelCoord[0], PixelCoord[1]);
+
+	CRNG RNG(PixelCoord[1] * gpTracer->FrameBuffer.Resolution[0] + PixelCoord[0], gpTracer->NoIterations);
 
 	ColorXYZf Lv = ColorXYZf::Black();
 
-	MetroSample Sample(RNG); 
+	MetroSample Sample;
 
 	Ray R;
 
-	SampleCamera(gpTracer->Camera, R, PixelCoord[0], PixelCoord[1], Sample.CameraSample);
+	SamplePixel(PixelCoord, RNG, Sample, R);
 
 	ScatterEvent SE;
 
@@ -22,7 +22,8 @@ class EXPOSURE_RENDER_DLL Texture : public ErTexture
 {
 public:
 	HOST Texture() :
-		ErTexture()
+		ErTexture(),
+		BitmapSlot(-1)
 	{
 	}
 
@@ -34,9 +35,13 @@ public:
 	HOST Texture& operator = (const ErTexture& Other)
 	{
 		ErTexture::operator=(Other);
+
+		this->BitmapSlot = -1;
 		
 		return *this;
 	}
+
+	int		BitmapSlot;
 };
 
 }
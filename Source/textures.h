@@ -95,8 +95,8 @@ HOST_DEVICE ColorXYZf EvaluateTexture(const int& ID, const Vec2f& UV)
 
 		case Enums::Bitmap:
 		{
-			if (T.BitmapID >= 0)
-				L = ColorXYZf::FromRGBAuc(gpBitmaps[T.BitmapID].Pixels(TextureUV, true));
+			if (T.BitmapSlot >= 0)
+				L = ColorXYZf::FromRGBAuc(gpBitmaps[T.BitmapSlot](TextureUV));
 
 			break;
 		}
@@ -0,0 +1,183 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "defines.h"
+#include "exception.h"
+#include "log.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+namespace Host
+{
+
+class ThreadPool
+{
+public:
+	HOST ThreadPool() :
+		Threads(),
+		Mutex(),
+		JobAvailable(),
+		JobDone(),
+		Job(),
+		NoItems(0),
+		NextItem(0),
+		NoActive(0),
+		Generation(0),
+		Stop(false),
+		Failed(false),
+		Error()
+	{
+	}
+
+	HOST ~ThreadPool()
+	{
+		this->Join();
+	}
+
+	HOST int GetNoThreads() const
+	{
+		return (int)this->Threads.size();
+	}
+
+	HOST void Resize(int NoThreads = 0)
+	{
+		if (NoThreads <= 0)
+			NoThreads = max((int)thread::hardware_concurrency(), 1);
+
+		if (NoThreads == this->GetNoThreads())
+			return;
+
+		DebugLog("%s, No. threads = %d", __FUNCTION__, NoThreads);
+
+		this->Join();
+
+		for (int i = 0; i < NoThreads; i++)
+			this->Threads.push_back(thread(&ThreadPool::Work, this, this->Generation));
+	}
+
+	HOST void ParallelFor(const int& NoItems, const function<void(const int&)>& Job)
+	{
+		if (NoItems <= 0)
+			return;
+
+		if (this->Threads.empty())
+			this->Resize();
+
+		unique_lock<mutex> Lock(this->Mutex);
+
+		this->Job		= Job;
+		this->NoItems	= NoItems;
+		this->NextItem	= 0;
+		this->NoActive	= this->GetNoThreads();
+		this->Failed	= false;
+		this->Generation++;
+
+		this->JobAvailable.notify_all();
+		this->JobDone.wait(Lock, [this] { return this->NoActive == 0; });
+
+		this->Job = nullptr;
+
+		if (this->Failed)
+			rethrow_exception(this->Error);
+	}
+
+private:
+	HOST void Join()
+	{
+		{
+			lock_guard<mutex> Lock(this->Mutex);
+			this->Stop = true;
+		}
+
+		this->JobAvailable.notify_all();
+
+		for (size_t i = 0; i < this->Threads.size(); i++)
+			this->Threads[i].join();
+
+		this->Threads.clear();
+		this->Stop = false;
+	}
+
+	HOST void Work(unsigned int Generation)
+	{
+		while (true)
+		{
+			{
+				unique_lock<mutex> Lock(this->Mutex);
+
+				this->JobAvailable.wait(Lock, [&] { return this->Stop || this->Generation != Generation; });
+
+				if (this->Stop)
+					return;
+
+				Generation = this->Generation;
+			}
+
+			for (int Item = this->NextItem++; Item < this->NoItems; Item = this->NextItem++)
+			{
+				try
+				{
+					this->Job(Item);
+				}
+				// Anything escaping a worker would terminate the application, so it is handed to the caller of ParallelFor
+				catch (...)
+				{
+					lock_guard<mutex> Lock(this->Mutex);
+
+					if (!this->Failed)
+					{
+						this->Failed	= true;
+						this->Error		= current_exception();
+					}
+				}
+			}
+
+			{
+				lock_guard<mutex> Lock(this->Mutex);
+
+				if (--this->NoActive == 0)
+					this->JobDone.notify_one();
+			}
+		}
+	}
+
+	vector<thread>					Threads;
+	mutex							Mutex;
+	condition_variable				JobAvailable;
+	condition_variable				JobDone;
+	function<void(const int&)>		Job;
+	int								NoItems;
+	atomic<int>						NextItem;
+	int								NoActive;
+	unsigned int					Generation;
+	bool							Stop;
+	bool							Failed;
+	exception_ptr					Error;
+};
+
+}
+
+}
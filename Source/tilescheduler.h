@@ -0,0 +1,186 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "threadpool.h"
+#include "buffer2d.h"
+
+#include <deque>
+#include <chrono>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+namespace Host
+{
+
+class TileScheduler
+{
+public:
+	class Tile
+	{
+	public:
+		Vec2i	ID;
+		Vec2i	Min;
+		Vec2i	Max;
+	};
+
+	HOST TileScheduler() :
+		Resolution(0),
+		TileSize(0),
+		NoTiles(0),
+		Tiles(),
+		Queues()
+	{
+	}
+
+	HOST void Run(ThreadPool& ThreadPool, const Vec2i& Resolution, const int& TileSize, Buffer2D<float>& TileTimings, const function<void(const Vec2i&, const Vec2i&)>& Job)
+	{
+		this->Update(Resolution, max(TileSize, 1));
+
+		if (this->Tiles.empty())
+			return;
+
+		TileTimings.Resize(this->NoTiles);
+
+		const int NoQueues = max(ThreadPool.GetNoThreads(), 1);
+
+		vector<Queue>(NoQueues).swap(this->Queues);
+
+		// Hand out contiguous runs of the Z-order curve so each thread starts on a compact screen region
+		for (int i = 0; i < (int)this->Tiles.size(); i++)
+			this->Queues[(int)(((long long)i * NoQueues) / this->Tiles.size())].TileIDs.push_back(i);
+
+		ThreadPool.ParallelFor(NoQueues, [&](const int& QueueID)
+		{
+			int TileID = 0;
+
+			while (this->Pop(QueueID, TileID) || this->Steal(QueueID, TileID))
+			{
+				const Tile& Tile = this->Tiles[TileID];
+
+				const chrono::high_resolution_clock::time_point Start = chrono::high_resolution_clock::now();
+
+				Job(Tile.Min, Tile.Max);
+
+				TileTimings(Tile.ID[0], Tile.ID[1]) = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - Start).count();
+			}
+		});
+	}
+
+	HOST static unsigned int MortonCode(unsigned int X, unsigned int Y)
+	{
+		X = (X | (X << 8)) & 0x00FF00FF;
+		X = (X | (X << 4)) & 0x0F0F0F0F;
+		X = (X | (X << 2)) & 0x33333333;
+		X = (X | (X << 1)) & 0x55555555;
+
+		Y = (Y | (Y << 8)) & 0x00FF00FF;
+		Y = (Y | (Y << 4)) & 0x0F0F0F0F;
+		Y = (Y | (Y << 2)) & 0x33333333;
+		Y = (Y | (Y << 1)) & 0x55555555;
+
+		return X | (Y << 1);
+	}
+
+private:
+	class Queue
+	{
+	public:
+		mutex		Mutex;
+		deque<int>	TileIDs;
+	};
+
+	HOST void Update(const Vec2i& Resolution, const int& TileSize)
+	{
+		if (this->Resolution == Resolution && this->TileSize == TileSize)
+			return;
+
+		this->Resolution	= Resolution;
+		this->TileSize		= TileSize;
+		this->NoTiles		= Vec2i((Resolution[0] + TileSize - 1) / TileSize, (Resolution[1] + TileSize - 1) / TileSize);
+
+		vector<pair<unsigned int, Tile> > SortedTiles;
+
+		for (int Y = 0; Y < this->NoTiles[1]; Y++)
+		{
+			for (int X = 0; X < this->NoTiles[0]; X++)
+			{
+				Tile Tile;
+
+				Tile.ID		= Vec2i(X, Y);
+				Tile.Min	= Vec2i(X * TileSize, Y * TileSize);
+				Tile.Max	= Vec2i(min((X + 1) * TileSize, Resolution[0]), min((Y + 1) * TileSize, Resolution[1]));
+
+				SortedTiles.push_back(make_pair(MortonCode(X, Y), Tile));
+			}
+		}
+
+		sort(SortedTiles.begin(), SortedTiles.end(), [](const pair<unsigned int, Tile>& A, const pair<unsigned int, Tile>& B) { return A.first < B.first; });
+
+		this->Tiles.clear();
+
+		for (size_t i = 0; i < SortedTiles.size(); i++)
+			this->Tiles.push_back(SortedTiles[i].second);
+	}
+
+	HOST bool Pop(const int& QueueID, int& TileID)
+	{
+		Queue& Queue = this->Queues[QueueID];
+
+		lock_guard<mutex> Lock(Queue.Mutex);
+
+		if (Queue.TileIDs.empty())
+			return false;
+
+		TileID = Queue.TileIDs.front();
+		Queue.TileIDs.pop_front();
+
+		return true;
+	}
+
+	HOST bool Steal(const int& QueueID, int& TileID)
+	{
+		const int NoQueues = (int)this->Queues.size();
+
+		for (int i = 1; i < NoQueues; i++)
+		{
+			Queue& Victim = this->Queues[(QueueID + i) % NoQueues];
+
+			lock_guard<mutex> Lock(Victim.Mutex);
+
+			if (Victim.TileIDs.empty())
+				continue;
+
+			TileID = Victim.TileIDs.back();
+			Victim.TileIDs.pop_back();
+
+			return true;
+		}
+
+		return false;
+	}
+
+	Vec2i			Resolution;
+	int				TileSize;
+	Vec2i			NoTiles;
+	vector<Tile>	Tiles;
+	vector<Queue>	Queues;
+};
+
+}
+
+}
@@ -25,7 +25,10 @@ public:
 	HOST KernelTiming()
 	{
 		sprintf_s(this->Event, MAX_CHAR_SIZE, "Undefined");
-		this->Duration = 0.0f;
+		this->Duration		= 0.0f;
+		this->Mean			= 0.0f;
+		this->P95			= 0.0f;
+		this->NoSamples		= 0;
 	}
 	
 	HOST ~KernelTiming()
@@ -40,19 +43,28 @@ public:
 	HOST KernelTiming(const char* pEvent, const float& Duration)
 	{
 		sprintf_s(this->Event, MAX_CHAR_SIZE, pEvent);
-		this->Duration = Duration;
+		this->Duration		= Duration;
+		this->Mean			= Duration;
+		this->P95			= Duration;
+		this->NoSamples		= 1;
 	}
 
 	HOST KernelTiming& operator = (const KernelTiming& Other)
 	{
 		sprintf_s(this->Event, MAX_CHAR_SIZE, Other.Event);
-		this->Duration = Other.Duration;
+		this->Duration		= Other.Duration;
+		this->Mean			= Other.Mean;
+		this->P95			= Other.P95;
+		this->NoSamples		= Other.NoSamples;
 
 		return *this;
 	}
 
 	char	Event[MAX_CHAR_SIZE];
 	float	Duration;
+	float	Mean;
+	float	P95;
+	int		NoSamples;
 };
 
 }
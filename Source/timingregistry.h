@@ -0,0 +1,178 @@
+/*
+	Copyright (c) 2011, T. Kroes <t.kroes@tudelft.nl>
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+	- Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+	- Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+	- Neither the name of the TU Delft nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "timing.h"
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+namespace ExposureRender
+{
+
+namespace Host
+{
+
+class TimingRegistry
+{
+public:
+	HOST TimingRegistry() :
+		Stages(),
+		Mutex()
+	{
+	}
+
+	HOST TimingRegistry(const TimingRegistry& Other) :
+		Stages(Other.Stages),
+		Mutex()
+	{
+	}
+
+	HOST TimingRegistry& operator = (const TimingRegistry& Other)
+	{
+		this->Stages = Other.Stages;
+
+		return *this;
+	}
+
+	HOST void Add(const char* pEvent, const float& Duration)
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		Stage* pStage = NULL;
+
+		for (size_t i = 0; i < this->Stages.size(); i++)
+		{
+			if (strcmp(this->Stages[i].Event, pEvent) == 0)
+			{
+				pStage = &this->Stages[i];
+				break;
+			}
+		}
+
+		if (pStage == NULL)
+		{
+			this->Stages.push_back(Stage());
+
+			pStage = &this->Stages.back();
+
+			sprintf_s(pStage->Event, MAX_CHAR_SIZE, "%s", pEvent);
+		}
+
+		pStage->Durations[pStage->NoSamples % MAX_TIMING_SAMPLES] = Duration;
+		pStage->NoSamples++;
+	}
+
+	HOST int GetNoTimings()
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		return (int)this->Stages.size();
+	}
+
+	// Statistics are computed over the last MAX_TIMING_SAMPLES durations of each stage, in the order the stages were first recorded
+	HOST int GetTimings(KernelTiming* pTimings, const int& MaxNoTimings)
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		const int NoTimings = min((int)this->Stages.size(), MaxNoTimings);
+
+		float Window[MAX_TIMING_SAMPLES];
+
+		for (int i = 0; i < NoTimings; i++)
+		{
+			const Stage& Stage = this->Stages[i];
+
+			const int NoSamples = min(Stage.NoSamples, MAX_TIMING_SAMPLES);
+
+			float Sum = 0.0f;
+
+			for (int j = 0; j < NoSamples; j++)
+			{
+				Window[j]	= Stage.Durations[j];
+				Sum			+= Window[j];
+			}
+
+			const int P95ID = min((int)ceilf(0.95f * NoSamples) - 1, NoSamples - 1);
+
+			nth_element(Window, Window + P95ID, Window + NoSamples);
+
+			sprintf_s(pTimings[i].Event, MAX_CHAR_SIZE, "%s", Stage.Event);
+
+			pTimings[i].Duration	= Stage.Durations[(Stage.NoSamples - 1) % MAX_TIMING_SAMPLES];
+			pTimings[i].Mean		= Sum / (float)NoSamples;
+			pTimings[i].P95			= Window[P95ID];
+			pTimings[i].NoSamples	= Stage.NoSamples;
+		}
+
+		return NoTimings;
+	}
+
+	HOST void Reset()
+	{
+		lock_guard<mutex> Lock(this->Mutex);
+
+		this->Stages.clear();
+	}
+
+private:
+	class Stage
+	{
+	public:
+		HOST Stage() :
+			NoSamples(0)
+		{
+			this->Event[0] = '\0';
+		}
+
+		char	Event[MAX_CHAR_SIZE];
+		float	Durations[MAX_TIMING_SAMPLES];
+		int		NoSamples;
+	};
+
+	vector<Stage>	Stages;
+	mutex			Mutex;
+};
+
+class ScopedTiming
+{
+public:
+	HOST ScopedTiming(TimingRegistry* pRegistry, const char* pEvent) :
+		pRegistry(pRegistry),
+		pEvent(pEvent),
+		Start(chrono::high_resolution_clock::now())
+	{
+	}
+
+	HOST ~ScopedTiming()
+	{
+		if (this->pRegistry)
+			this->pRegistry->Add(this->pEvent, chrono::duration<float, milli>(chrono::high_resolution_clock::now() - this->Start).count());
+	}
+
+private:
+	TimingRegistry*							pRegistry;
+	const char*								pEvent;
+	chrono::high_resolution_clock::time_point	Start;
+};
+
+}
+
+}
@@ -15,6 +15,11 @@
 
 #include "ertracer.h"
 #include "framebuffer.h"
+#include "shadinglut.h"
+#include "bvh.h"
+#include "aliastable.h"
+#include "filter.h"
+#include "idindex.h"
 
 #include <map>
 
@@ -28,7 +33,17 @@ class Tracer : public ErTracer
 public:
 	HOST Tracer() :
 		ErTracer(),
-		FrameBuffer()
+		FrameBuffer(),
+		ShadingLUT(),
+		LightBVH(),
+		ObjectBVH(),
+		LightSelection(),
+		FrameFilter(),
+		VolumeSlot(-1),
+		LightSlots(),
+		ObjectSlots(),
+		ClippingObjectSlots(),
+		SlotsVersion(-1)
 	{
 	}
 
@@ -41,12 +56,61 @@ public:
 	{
 		ErTracer::operator=(Other);
 		
+		const int& Resolution = Other.RenderSettings.Shading.TransferFunctionResolution;
+
+		this->ShadingLUT.Build(Other, Resolution);
+
+		this->Opacity1D.Bake(Resolution);
+
+		this->FrameBuffer.SetMemoryType(Other.Backend == Enums::HostBackend ? Enums::Host : Enums::Device);
 		this->FrameBuffer.Resize(Other.Camera.FilmSize);
 
+		this->LightBVH.Version	= -1;
+		this->ObjectBVH.Version	= -1;
+
+		this->LightSelection.Version = -1;
+
+		this->FrameFilter.Build(1, 1.0f);
+
+		this->SlotsVersion = -1;
+
 		return *this;
 	}
 
-	FrameBuffer	FrameBuffer;
+	// The render code indexes the lists by slot, IDs that are not bound are skipped
+	HOST void ResolveIDs(const IDIndex& Volumes, const IDIndex& Lights, const IDIndex& Objects, const IDIndex& ClippingObjects)
+	{
+		this->VolumeSlot = Volumes[this->VolumeID];
+
+		ResolveIDs(this->LightIDs, this->LightSlots, Lights);
+		ResolveIDs(this->ObjectIDs, this->ObjectSlots, Objects);
+		ResolveIDs(this->ClippingObjectIDs, this->ClippingObjectSlots, ClippingObjects);
+	}
+
+	HOST static void ResolveIDs(const Indices& IDs, Indices& Slots, const IDIndex& Index)
+	{
+		Slots.Count = 0;
+
+		for (int i = 0; i < IDs.Count; i++)
+		{
+			const int Slot = Index[IDs[i]];
+
+			if (Slot >= 0)
+				Slots[Slots.Count++] = Slot;
+		}
+	}
+
+	FrameBuffer		FrameBuffer;
+	ShadingLUT		ShadingLUT;
+	BVH				LightBVH;
+	BVH				ObjectBVH;
+	AliasTable		LightSelection;
+	GaussianFilter	FrameFilter;
+	int				VolumeSlot;
+	Indices			LightSlots;
+	Indices			ObjectSlots;
+	Indices			ClippingObjectSlots;
+	int				SlotsVersion;
 };
 
 }
@@ -77,7 +77,11 @@ public:
 class EXPOSURE_RENDER_DLL ScalarTransferFunction1D
 {
 public:
-	HOST ScalarTransferFunction1D()
+	HOST ScalarTransferFunction1D() :
+		PLF(),
+		LUTSize(0),
+		LUTRange(0.0f),
+		LUTScale(0.0f)
 	{
 	}
 
@@ -92,7 +96,17 @@ public:
 
 	HOST ScalarTransferFunction1D& operator = (const ScalarTransferFunction1D& Other)
 	{	
-		this->PLF = Other.PLF;
+		this->PLF		= Other.PLF;
+		this->LUTSize	= Other.LUTSize;
+		this->LUTRange	= Other.LUTRange;
+		this->LUTScale	= Other.LUTScale;
+
+		for (int i = 0; i < this->LUTSize; i++)
+			this->LUT[i] = Other.LUT[i];
+
+		for (int K = 1; (1 << K) <= this->LUTSize; K++)
+			for (int i = 0; i + (1 << K) <= this->LUTSize; i++)
+				this->LUTMaxima[K - 1][i] = Other.LUTMaxima[K - 1][i];
 		
 		return *this;
 	}
@@ -100,14 +114,75 @@ public:
 	HOST void AddNode(const ScalarNode& Node)
 	{
 		this->PLF.AddNode(Node.Position, Node.Value);
+		this->LUTSize = 0;
+	}
+
+	HOST void Bake(const int& Resolution)
+	{
+		this->LUTSize = 0;
+
+		if (this->PLF.GetNoNodes() <= 0 || Resolution < 2)
+			return;
+
+		this->LUTSize	= min(Resolution, MAX_TF_LUT_SIZE);
+		this->LUTRange	= this->PLF.GetNodeRange();
+
+		const float Range = this->LUTRange[1] - this->LUTRange[0];
+
+		this->LUTScale = Range > 0.0f ? (float)(this->LUTSize - 1) / Range : 0.0f;
+
+		for (int i = 0; i < this->LUTSize; i++)
+			this->LUT[i] = this->PLF.Evaluate(this->LUTRange[0] + Range * ((float)i / (float)(this->LUTSize - 1)));
+
+		for (int K = 1; (1 << K) <= this->LUTSize; K++)
+		{
+			const float* pPrevious = this->GetMaxima(K - 1);
+
+			for (int i = 0; i + (1 << K) <= this->LUTSize; i++)
+				this->LUTMaxima[K - 1][i] = fmaxf(pPrevious[i], pPrevious[i + (1 << (K - 1))]);
+		}
 	}
 
 	HOST_DEVICE float Evaluate(const float& Intensity) const
 	{
-		return this->PLF.Evaluate(Intensity);
+		if (this->LUTSize <= 0)
+			return this->PLF.Evaluate(Intensity);
+
+		const float U = Clamp((Intensity - this->LUTRange[0]) * this->LUTScale, 0.0f, (float)(this->LUTSize - 1));
+		const int I = min((int)U, this->LUTSize - 2);
+		const float T = U - (float)I;
+
+		return this->LUT[I] + T * (this->LUT[I + 1] - this->LUT[I]);
+	}
+
+	HOST_DEVICE float Maximum(const float& MinIntensity, const float& MaxIntensity) const
+	{
+		if (this->LUTSize <= 0)
+			return this->PLF.Maximum(MinIntensity, MaxIntensity);
+
+		const int Min = (int)floorf(Clamp((MinIntensity - this->LUTRange[0]) * this->LUTScale, 0.0f, (float)(this->LUTSize - 1)));
+		const int Max = (int)ceilf(Clamp((MaxIntensity - this->LUTRange[0]) * this->LUTScale, 0.0f, (float)(this->LUTSize - 1)));
+
+		// Two overlapping power of two spans cover [Min, Max]
+		const int K = ilogbf((float)(Max - Min + 1));
+
+		const float* pMaxima = this->GetMaxima(K);
+
+		return fmaxf(pMaxima[Min], pMaxima[Max - (1 << K) + 1]);
+	}
+
+	// Entry i of level K holds the LUT maximum over [i, i + 2^K), level 0 is the LUT itself
+	HOST_DEVICE const float* GetMaxima(const int& K) const
+	{
+		return K == 0 ? this->LUT : this->LUTMaxima[K - 1];
 	}
 
-	PiecewiseLinearFunction<MAX_NO_TF_NODES> PLF;
+	PiecewiseLinearFunction<MAX_NO_TF_NODES>	PLF;
+	float										LUT[MAX_TF_LUT_SIZE];
+	float										LUTMaxima[MAX_TF_LUT_LEVELS][MAX_TF_LUT_SIZE];
+	int											LUTSize;
+	Vec2f										LUTRange;
+	float										LUTScale;
 };
 
 class EXPOSURE_RENDER_DLL ColorTransferFunction1D
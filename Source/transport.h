@@ -38,45 +38,61 @@ HOST_DEVICE_NI bool Intersect(const Ray& R, CRNG& RNG)
 	return false;
 }
 
-HOST_DEVICE_NI bool Visible(const Vec3f& P1, const Vec3f& P2, CRNG& RNG)
+HOST_DEVICE_NI float Transmittance(const Vec3f& P1, const Vec3f& P2, CRNG& RNG)
 {
 	if (!gpTracer->RenderSettings.Traversal.Shadows)
-		return true;
+		return 1.0f;
 
 	Vec3f W = Normalize(P2 - P1);
 
 	const Ray R(P1 + W * RAY_EPS, W, 0.0f, min((P2 - P1).Length() - RAY_EPS_2, gpTracer->RenderSettings.Traversal.MaxShadowDistance));
 
-	return !Intersect(R, RNG);
+	if (gpTracer->RenderSettings.Traversal.Mode == Enums::DeltaTracking)
+	{
+		if (IntersectsLight(R) || IntersectsObject(R))
+			return 0.0f;
+
+		return RatioTracking(R, RNG);
+	}
+
+	return Intersect(R, RNG) ? 0.0f : 1.0f;
 }
 
-HOST_DEVICE_NI ColorXYZf EstimateDirectLight(const Light& Light, LightingSample& LS, ScatterEvent& SE, CRNG& RNG, Shader& Shader)
+HOST_DEVICE_NI ColorXYZf EstimateDirectLight(const Light& Light, const int& LightIndex, LightingSample& LS, ScatterEvent& SE, CRNG& RNG, Shader& Shader)
 {
+	const int& Strategy = gpTracer->RenderSettings.Shading.LightingStrategy;
+
 	Vec3f Wi;
 	
-	ColorXYZf Li, Ld;
+	ColorXYZf Li, Ld, F;
 
-	SurfaceSample SS;
+	float BsdfPdf = 0.0f;
 
-	SampleLight(Light, LS.LightSample, SS, SE, Wi, Li);
-	
-	ColorXYZf F = Shader.F(SE.Wo, Wi);
+	if (Strategy != Enums::BsdfSampling)
+	{
+		SurfaceSample SS;
+
+		SampleLight(Light, LS.LightSample, SS, SE, Wi, Li);
 	
-	float BsdfPdf = Shader.Pdf(SE.Wo, Wi);
+		F		= Shader.F(SE.Wo, Wi);
+		BsdfPdf	= Shader.Pdf(SE.Wo, Wi);
 
-	if (!Li.IsBlack() && !F.IsBlack() && BsdfPdf > 0.0f && Visible(SE.P, SS.P, RNG))
-	{
-		const float LightPdf = DistanceSquared(SE.P, SS.P) / (AbsDot(SS.N, -Wi) * Light.Shape.Area);
+		const float CosLight = AbsDot(SS.N, -Wi);
+
+		if (!Li.IsBlack() && !F.IsBlack() && BsdfPdf > 0.0f && CosLight > 0.0f)
+		{
+			Li *= Transmittance(SE.P, SS.P, RNG);
 
-		const float Weight = PowerHeuristic(1, LightPdf, 1, BsdfPdf);
+			const float LightPdf	= DistanceSquared(SE.P, SS.P) / (CosLight * Light.Shape.Area);
+			const float Weight		= Strategy == Enums::MultipleImportanceSampling ? PowerHeuristic(1, LightPdf, 1, BsdfPdf) : 1.0f;
+			const float CosTheta	= Shader.Type == Enums::Brdf ? AbsDot(Wi, SE.N) : 1.0f;
 
-		if (Shader.Type == Enums::Brdf)
-			Ld += F * Li * (AbsDot(Wi, SE.N) * Weight / LightPdf);
-		else
-			Ld += F * Li / LightPdf;
+			Ld += F * Li * (CosTheta * Weight / LightPdf);
+		}
 	}
 
-	return Ld;
+	if (Strategy == Enums::LightSampling)
+		return Ld;
 
 	F = Shader.SampleF(SE.Wo, Wi, BsdfPdf, LS.BrdfSample);
 
@@ -87,67 +103,86 @@ HOST_DEVICE_NI ColorXYZf EstimateDirectLight(const Light& Light, LightingSample&
 
 	IntersectLights(Ray(SE.P, Wi), SE2);
 	
-	if (!SE2.Valid || SE2.LightID != Light.ID)
+	if (!SE2.Valid || SE2.LightID != LightIndex)
 		return Ld;
 
 	Li = SE2.Le;
 
-	if (!Li.IsBlack() && Visible(SE.P, SE2.P, RNG))
+	const float CosLight = AbsDot(SE2.N, -Wi);
+
+	if (!Li.IsBlack() && CosLight > 0.0f)
 	{
-		const float LightPdf = DistanceSquared(SE.P, SE2.P) / (AbsDot(SE.N, -Wi) * Light.Shape.Area);
+		Li *= Transmittance(SE.P, SE2.P, RNG);
 
-		const float Weight = PowerHeuristic(1, BsdfPdf, 1, LightPdf);
+		const float LightPdf	= DistanceSquared(SE.P, SE2.P) / (CosLight * Light.Shape.Area);
+		const float Weight		= Strategy == Enums::MultipleImportanceSampling ? PowerHeuristic(1, BsdfPdf, 1, LightPdf) : 1.0f;
+		const float CosTheta	= Shader.Type == Enums::Brdf ? AbsDot(Wi, SE.N) : 1.0f;
 
-		if (Shader.Type == Enums::Brdf)
-			Ld += F * Li * (AbsDot(Wi, SE.N) * Weight / BsdfPdf);
-		else
-			Ld += F * Li / BsdfPdf;
+		Ld += F * Li * (CosTheta * Weight / BsdfPdf);
 	}
 	
 	return Ld;
 }
 
-HOST_DEVICE_NI ColorXYZf UniformSampleOneLight(ScatterEvent& SE, CRNG& RNG, LightingSample& LS)
+HOST_DEVICE_NI void GetShading(const ScatterEvent& SE, ColorXYZf& Emission, Shader& Shader)
 {
-	ColorXYZf Ld;
+	const float Intensity = GetIntensity(gpTracer->VolumeSlot, SE.P);
 
-	const float Intensity = GetIntensity(gpTracer->VolumeID, SE.P);
+	ShadingLUT::Record Shading;
 
-	Ld += gpTracer->Emission1D.Evaluate(Intensity);
+	if (!gpTracer->ShadingLUT.Lookup(Intensity, Shading))
+		ShadingLUT::Evaluate(*gpTracer, Intensity, Shading);
 
-	if (gpTracer->LightIDs.Count <= 0)
-		return Ld;
-
-	const int LightID = gpTracer->LightIDs[(int)floorf(LS.LightNum * gpTracer->LightIDs.Count)];
+	Emission = Shading.Emission;
 
-	if (LightID < 0)
-		return Ld;
-
-	const Light& Light = gpLights[LightID];
-	
-	Shader Shader;
-	
 	switch (SE.Type)
 	{
-		case Enums::Volume:	
-			Shader = ExposureRender::Shader(Enums::Brdf, SE.N, SE.Wo, gpTracer->Diffuse1D.Evaluate(Intensity), gpTracer->Specular1D.Evaluate(Intensity), 15.0f, GlossinessExponent(gpTracer->Glossiness1D.Evaluate(Intensity)));
+		case Enums::Volume:
+		{
+			const Enums::ScatterFunction Type = gpTracer->RenderSettings.Shading.Type == Enums::PhaseFunctionOnly ? Enums::PhaseFunction : Enums::Brdf;
+
+			Shader = ExposureRender::Shader(Type, SE.N, SE.Wo, Shading.Diffuse, Shading.Specular, 15.0f, Shading.Exponent);
 			break;
+		}
 
 		case Enums::Object:
 		{
-			const ColorXYZf Diffuse		= EvaluateTexture(gpObjects[SE.ObjectID].DiffuseTextureID, SE.UV);
-			const ColorXYZf Specular	= EvaluateTexture(gpObjects[SE.ObjectID].SpecularTextureID, SE.UV);
-			const ColorXYZf Glossiness	= EvaluateTexture(gpObjects[SE.ObjectID].GlossinessTextureID, SE.UV);
+			const ColorXYZf Diffuse		= EvaluateTexture(gpObjects[SE.ObjectID].DiffuseTextureSlot, SE.UV);
+			const ColorXYZf Specular	= EvaluateTexture(gpObjects[SE.ObjectID].SpecularTextureSlot, SE.UV);
+			const ColorXYZf Glossiness	= EvaluateTexture(gpObjects[SE.ObjectID].GlossinessTextureSlot, SE.UV);
 
 			Shader = ExposureRender::Shader(Enums::Brdf, SE.N, SE.Wo, Diffuse, Specular, 15.0f, GlossinessExponent(Glossiness.Y()));
 			break;
 		}
 	}
-	/**/
+}
+
+HOST_DEVICE_NI ColorXYZf SampleOneLight(ScatterEvent& SE, CRNG& RNG, LightingSample& LS, Shader& Shader)
+{
+	if (gpTracer->LightSlots.Count <= 0)
+		return ColorXYZf::Black();
+
+	float SelectionPdf = 0.0f;
+
+	const int LightIndex = gpTracer->LightSelection.Sample(LS.LightNum, SelectionPdf);
+
+	if (LightIndex < 0 || SelectionPdf <= 0.0f)
+		return ColorXYZf::Black();
 
-	Ld += EstimateDirectLight(Light, LS, SE, RNG, Shader);
+	return EstimateDirectLight(gpLights[gpTracer->LightSlots[LightIndex]], LightIndex, LS, SE, RNG, Shader) / SelectionPdf;
+}
+
+HOST_DEVICE_NI ColorXYZf UniformSampleOneLight(ScatterEvent& SE, CRNG& RNG, LightingSample& LS)
+{
+	ColorXYZf Ld;
 
-	return (float)gpTracer->LightIDs.Count * Ld;
+	Shader Shader;
+
+	GetShading(SE, Ld, Shader);
+
+	Ld += SampleOneLight(SE, RNG, LS, Shader);
+
+	return Ld;
 }
 
-}
\ No newline at end of file
+}
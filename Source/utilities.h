@@ -61,4 +61,9 @@ HOST_DEVICE ColorXYZf CumulativeMovingAverage(const ColorXYZf& A, const ColorXYZ
 	 return A + ((Ax - A) / max((float)N, 1.0f));
 }
 
+HOST_DEVICE Vec4f CumulativeMovingAverage(const Vec4f& A, const Vec4f& Ax, const int& N)
+{
+	return A + (Ax - A) / max((float)N, 1.0f);
+}
+
 }
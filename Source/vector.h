@@ -551,7 +551,7 @@ class EXPOSURE_RENDER_DLL Indices
 public:
 	HOST Indices()
 	{
-		for (int i = 0; i < 256; i++)
+		for (int i = 0; i < MAX_NO_INDICES; i++)
 			this->D[i] = -1;
 
 		this->Count = 0;
@@ -561,7 +561,7 @@ public:
 	
 	HOST Indices& operator = (const Indices& Other)
 	{
-		for (int i = 0; i < 256; i++)
+		for (int i = 0; i < MAX_NO_INDICES; i++)
 			this->D[i] = Other.D[i];
 
 		this->Count = Other.Count;
@@ -569,7 +569,7 @@ public:
 		return *this;
 	}
 
-	int D[256];
+	int D[MAX_NO_INDICES];
 	int Count;
 };
 
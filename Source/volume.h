@@ -15,6 +15,10 @@
 
 #include "ervolume.h"
 #include "boundingbox.h"
+#include "threadpool.h"
+
+#include <limits.h>
+#include <algorithm>
 
 namespace ExposureRender
 {
@@ -32,7 +36,17 @@ public:
 		Size(1.0f),
 		InvSize(1.0f),
 		MinStep(1.0f),
-		Voxels(Enums::Device, "Device Voxels")
+		Resolution(0),
+		Voxels(Enums::Device, "Device Voxels"),
+		HostVoxels(Enums::Host, "Host Voxels"),
+		MacroCellSize(1.0f),
+		MacroCells(Enums::Device, "Device Macro Cells"),
+		HostMacroCells(Enums::Host, "Host Macro Cells"),
+		GradientScale(0.0f),
+		Gradients(Enums::Device, "Device Gradients"),
+		HostGradients(Enums::Host, "Host Gradients"),
+		File(),
+		BrickCache()
 	{
 		DebugLog(__FUNCTION__);
 	}
@@ -52,7 +66,17 @@ public:
 		Size(1.0f),
 		InvSize(1.0f),
 		MinStep(1.0f),
-		Voxels(Enums::Device, "Device Voxels")
+		Resolution(0),
+		Voxels(Enums::Device, "Device Voxels"),
+		HostVoxels(Enums::Host, "Host Voxels"),
+		MacroCellSize(1.0f),
+		MacroCells(Enums::Device, "Device Macro Cells"),
+		HostMacroCells(Enums::Host, "Host Macro Cells"),
+		GradientScale(0.0f),
+		Gradients(Enums::Device, "Device Gradients"),
+		HostGradients(Enums::Host, "Host Gradients"),
+		File(),
+		BrickCache()
 	{
 		DebugLog(__FUNCTION__);
 		*this = Other;
@@ -68,12 +92,48 @@ public:
 		Size(1.0f),
 		InvSize(1.0f),
 		MinStep(1.0f),
-		Voxels(Enums::Device, "Device Voxels")
+		Resolution(0),
+		Voxels(Enums::Device, "Device Voxels"),
+		HostVoxels(Enums::Host, "Host Voxels"),
+		MacroCellSize(1.0f),
+		MacroCells(Enums::Device, "Device Macro Cells"),
+		HostMacroCells(Enums::Host, "Host Macro Cells"),
+		GradientScale(0.0f),
+		Gradients(Enums::Device, "Device Gradients"),
+		HostGradients(Enums::Host, "Host Gradients"),
+		File(),
+		BrickCache()
 	{
 		DebugLog(__FUNCTION__);
 		*this = Other;
 	}
 
+	HOST Volume(ErVolume&& Other) :
+		BoundingBox(),
+		GradientDeltaX(),
+		GradientDeltaY(),
+		GradientDeltaZ(),
+		Spacing(1.0f),
+		InvSpacing(1.0f),
+		Size(1.0f),
+		InvSize(1.0f),
+		MinStep(1.0f),
+		Resolution(0),
+		Voxels(Enums::Device, "Device Voxels"),
+		HostVoxels(Enums::Host, "Host Voxels"),
+		MacroCellSize(1.0f),
+		MacroCells(Enums::Device, "Device Macro Cells"),
+		HostMacroCells(Enums::Host, "Host Macro Cells"),
+		GradientScale(0.0f),
+		Gradients(Enums::Device, "Device Gradients"),
+		HostGradients(Enums::Host, "Host Gradients"),
+		File(),
+		BrickCache()
+	{
+		DebugLog(__FUNCTION__);
+		*this = move(Other);
+	}
+
 	HOST Volume& Volume::operator = (const Volume& Other)
 	{
 		DebugLog(__FUNCTION__);
@@ -87,7 +147,17 @@ public:
 		this->Size				= Other.Size;
 		this->InvSize			= Other.InvSize;
 		this->MinStep			= Other.MinStep;
+		this->Resolution		= Other.Resolution;
 		this->Voxels			= Other.Voxels;
+		this->HostVoxels		= Other.HostVoxels;
+		this->MacroCellSize		= Other.MacroCellSize;
+		this->MacroCells		= Other.MacroCells;
+		this->HostMacroCells	= Other.HostMacroCells;
+		this->GradientScale		= Other.GradientScale;
+		this->Gradients			= Other.Gradients;
+		this->HostGradients		= Other.HostGradients;
+		this->File				= Other.File;
+		this->BrickCache		= Other.BrickCache;
 
 		return *this;
 	}
@@ -96,19 +166,55 @@ public:
 	{
 		DebugLog(__FUNCTION__);
 
-		this->Voxels = Other.Voxels;
+		if (Other.Voxels.Dirty)
+		{
+			this->HostVoxels	= Other.Voxels;
+			this->File			= Other.File;
+			this->BrickCache	= Other.BrickCache;
+		}
+
+		this->Update(Other);
+
+		return *this;
+	}
+
+	// Takes over new voxels instead of copying them, so the host holds them only once, Other is left without voxels
+	HOST Volume& Volume::operator = (ErVolume&& Other)
+	{
+		DebugLog(__FUNCTION__);
+
+		if (Other.Voxels.Dirty)
+		{
+			this->HostVoxels	= move(Other.Voxels);
+			this->File			= Other.File;
+			this->BrickCache	= Other.BrickCache;
+		}
+
+		this->Update(Other);
+
+		return *this;
+	}
+
+	HOST void Update(const ErVolume& Other)
+	{
+		this->HostVoxels.SetLayout(Other.Layout);
+
+		if (Cuda::DeviceAvailable())
+			this->Voxels = this->HostVoxels;
+
+		this->Resolution = this->BrickCache ? this->BrickCache->GetResolution() : this->HostVoxels.Resolution;
 
 		float Scale = 0.0f;
 
 		if (Other.NormalizeSize)
 		{
-			const Vec3f PhysicalSize = Vec3f((float)this->Voxels.Resolution[0], (float)this->Voxels.Resolution[1], (float)this->Voxels.Resolution[2]) * Other.Spacing;
+			const Vec3f PhysicalSize = Vec3f((float)this->Resolution[0], (float)this->Resolution[1], (float)this->Resolution[2]) * Other.Spacing;
 			Scale = 1.0f / max(PhysicalSize[0], max(PhysicalSize[1], PhysicalSize[2]));
 		}
 
 		this->Spacing		= Scale * Other.Spacing;
 		this->InvSpacing	= 1.0f / this->Spacing;
-		this->Size			= Vec3f((float)this->Voxels.Resolution[0] * this->Spacing[0], (float)this->Voxels.Resolution[1] *this->Spacing[1], (float)this->Voxels.Resolution[2] * this->Spacing[2]);
+		this->Size			= Vec3f((float)this->Resolution[0] * this->Spacing[0], (float)this->Resolution[1] *this->Spacing[1], (float)this->Resolution[2] * this->Spacing[2]);
 		this->InvSize		= 1.0f / this->Size;
 
 		this->BoundingBox.SetMinP(-0.5 * Size);
@@ -120,28 +226,239 @@ public:
 		this->GradientDeltaY = Vec3f(0.0f, this->MinStep, 0.0f);
 		this->GradientDeltaZ = Vec3f(0.0f, 0.0f, this->MinStep);
 
-		return *this;
+		this->ComputeMacroCells();
+
+		if (Other.PrecomputeGradients && !this->BrickCache)
+			this->ComputeGradients(Other.Layout);
+		else
+			this->FreeGradients();
+	}
+
+	HOST void ComputeMacroCells()
+	{
+		const Vec3i Resolution = this->HostVoxels.Resolution;
+
+		this->MacroCellSize = (float)MACRO_CELL_SIZE * this->Spacing;
+
+		// Streamed volumes bring their macro cells along, so finding empty space loads no bricks
+		if (this->BrickCache)
+		{
+			this->HostMacroCells.Wrap(this->BrickCache->GetNoMacroCells(), this->BrickCache->GetMacroCells());
+
+			if (Cuda::DeviceAvailable())
+				this->MacroCells = this->HostMacroCells;
+
+			return;
+		}
+
+		this->HostMacroCells.Resize(Vec3i((Resolution[0] + MACRO_CELL_SIZE - 1) / MACRO_CELL_SIZE, (Resolution[1] + MACRO_CELL_SIZE - 1) / MACRO_CELL_SIZE, (Resolution[2] + MACRO_CELL_SIZE - 1) / MACRO_CELL_SIZE));
+
+		for (int Z = 0; Z < this->HostMacroCells.Resolution[2]; Z++)
+		{
+			for (int Y = 0; Y < this->HostMacroCells.Resolution[1]; Y++)
+			{
+				for (int X = 0; X < this->HostMacroCells.Resolution[0]; X++)
+				{
+					unsigned short Min = USHRT_MAX, Max = 0;
+
+					// Include the first voxel of the next cell, trilinear lookups near the border read it
+					for (int VZ = Z * MACRO_CELL_SIZE; VZ <= min((Z + 1) * MACRO_CELL_SIZE, Resolution[2] - 1); VZ++)
+					{
+						for (int VY = Y * MACRO_CELL_SIZE; VY <= min((Y + 1) * MACRO_CELL_SIZE, Resolution[1] - 1); VY++)
+						{
+							for (int VX = X * MACRO_CELL_SIZE; VX <= min((X + 1) * MACRO_CELL_SIZE, Resolution[0] - 1); VX++)
+							{
+								const unsigned short Voxel = this->HostVoxels(VX, VY, VZ);
+
+								Min = min(Min, Voxel);
+								Max = max(Max, Voxel);
+							}
+						}
+					}
+
+					this->HostMacroCells(X, Y, Z) = ((unsigned int)Max << 16) | Min;
+				}
+			}
+		}
+
+		if (Cuda::DeviceAvailable())
+			this->MacroCells = this->HostMacroCells;
+	}
+
+	HOST void ComputeGradients(const Enums::VoxelLayout& Layout)
+	{
+		const Vec3i Resolution = this->HostVoxels.Resolution;
+
+		if (Resolution[0] <= 0 || Resolution[1] <= 0 || Resolution[2] <= 0)
+		{
+			this->FreeGradients();
+			return;
+		}
+
+		Host::ThreadPool ThreadPool;
+
+		vector<float> MaxMagnitude(Resolution[2], 0.0f);
+
+		ThreadPool.ParallelFor(Resolution[2], [&](const int& Z)
+		{
+			for (int Y = 0; Y < Resolution[1]; Y++)
+				for (int X = 0; X < Resolution[0]; X++)
+					MaxMagnitude[Z] = fmaxf(MaxMagnitude[Z], this->VoxelGradient(X, Y, Z).Length());
+		});
+
+		const float Max = *max_element(MaxMagnitude.begin(), MaxMagnitude.end());
+
+		this->GradientScale = Max / 255.0f;
+
+		this->HostGradients.SetLayout(Enums::LinearLayout);
+		this->HostGradients.Resize(Resolution);
+
+		// Pack an octahedral unit normal in the low 16 bits and the magnitude, quantized against the volume maximum, in the next 8
+		ThreadPool.ParallelFor(Resolution[2], [&](const int& Z)
+		{
+			for (int Y = 0; Y < Resolution[1]; Y++)
+			{
+				for (int X = 0; X < Resolution[0]; X++)
+				{
+					const Vec3f Gradient = this->VoxelGradient(X, Y, Z);
+					const unsigned int Magnitude = Max > 0.0f ? (unsigned int)(Gradient.Length() / Max * 255.0f + 0.5f) : 0;
+
+					this->HostGradients(X, Y, Z) = (min(Magnitude, 255u) << 16) | EncodeOctahedral(Gradient);
+				}
+			}
+		});
+
+		this->HostGradients.SetLayout(Layout);
+
+		if (Cuda::DeviceAvailable())
+			this->Gradients = this->HostGradients;
+	}
+
+	HOST void FreeGradients()
+	{
+		this->GradientScale = 0.0f;
+		this->HostGradients.Free();
+		this->Gradients.Free();
+	}
+
+	HOST Vec3f VoxelGradient(const int& X, const int& Y, const int& Z) const
+	{
+		const float DX = (float)this->HostVoxels(X - 1, Y, Z) - (float)this->HostVoxels(X + 1, Y, Z);
+		const float DY = (float)this->HostVoxels(X, Y - 1, Z) - (float)this->HostVoxels(X, Y + 1, Z);
+		const float DZ = (float)this->HostVoxels(X, Y, Z - 1) - (float)this->HostVoxels(X, Y, Z + 1);
+
+		return Vec3f(DX * 0.5f / this->Spacing[0], DY * 0.5f / this->Spacing[1], DZ * 0.5f / this->Spacing[2]);
+	}
+
+	HOST_DEVICE bool HasGradients() const
+	{
+		return this->HostGradients.GetNoElements() > 0;
+	}
+
+	HOST_DEVICE void GetGradient(const Vec3f& XYZ, Vec3f& Gradient, float& Magnitude) const
+	{
+		const Vec3f LocalXYZ = (XYZ - this->BoundingBox.MinP) * this->InvSize * Vec3f(this->Resolution[0], this->Resolution[1], this->Resolution[2]);
+
+		const int vx = (int)floorf(LocalXYZ[0]);
+		const int vy = (int)floorf(LocalXYZ[1]);
+		const int vz = (int)floorf(LocalXYZ[2]);
+
+		const float dx = LocalXYZ[0] - vx;
+		const float dy = LocalXYZ[1] - vy;
+		const float dz = LocalXYZ[2] - vz;
+
+		Gradient	= Vec3f(0.0f);
+		Magnitude	= 0.0f;
+
+		for (int i = 0; i < 8; i++)
+		{
+			const int CX = i & 1, CY = (i >> 1) & 1, CZ = i >> 2;
+
+#ifdef __CUDA_ARCH__
+			const unsigned int Packed = this->Gradients(vx + CX, vy + CY, vz + CZ);
+#else
+			const unsigned int Packed = this->HostGradients(vx + CX, vy + CY, vz + CZ);
+#endif
+
+			const float Weight		= (CX ? dx : 1.0f - dx) * (CY ? dy : 1.0f - dy) * (CZ ? dz : 1.0f - dz);
+			const float Length		= (float)(Packed >> 16) * this->GradientScale;
+
+			Gradient	+= (Weight * Length) * DecodeOctahedral(Packed & 0xFFFF);
+			Magnitude	+= Weight * Length;
+		}
 	}
 
 	HOST_DEVICE unsigned short operator()(const Vec3f& XYZ = Vec3f(0.0f)) const
 	{
 		const Vec3f Offset = XYZ - this->BoundingBox.MinP;
 		
-		const Vec3f LocalXYZ = Offset * this->InvSize * Vec3f(this->Voxels.Resolution[0], this->Voxels.Resolution[1], this->Voxels.Resolution[2]);
+		const Vec3f LocalXYZ = Offset * this->InvSize * Vec3f(this->Resolution[0], this->Resolution[1], this->Resolution[2]);
 
+#ifdef __CUDA_ARCH__
 		return this->Voxels(LocalXYZ);
+#else
+		if (this->BrickCache)
+			return this->BrickCache->Trilinear(LocalXYZ);
+
+		return this->HostVoxels(LocalXYZ);
+#endif
+	}
+
+	HOST_DEVICE bool IsStreamed() const
+	{
+#ifdef __CUDA_ARCH__
+		return false;
+#else
+		return this->BrickCache != NULL;
+#endif
+	}
+
+	HOST_DEVICE void Prefetch(const Vec3f& XYZ) const
+	{
+#ifndef __CUDA_ARCH__
+		if (this->BrickCache)
+			this->BrickCache->Prefetch((XYZ - this->BoundingBox.MinP) * this->InvSize * Vec3f(this->Resolution[0], this->Resolution[1], this->Resolution[2]));
+#endif
+	}
+
+	HOST_DEVICE Vec3i GetMacroCellID(const Vec3f& XYZ) const
+	{
+		const Vec3f MacroCellXYZ = (XYZ - this->BoundingBox.MinP) * this->InvSpacing / (float)MACRO_CELL_SIZE;
+
+		return Vec3i(Clamp((int)floorf(MacroCellXYZ[0]), 0, this->HostMacroCells.Resolution[0] - 1), Clamp((int)floorf(MacroCellXYZ[1]), 0, this->HostMacroCells.Resolution[1] - 1), Clamp((int)floorf(MacroCellXYZ[2]), 0, this->HostMacroCells.Resolution[2] - 1));
+	}
+
+	HOST_DEVICE Vec2f GetMacroCellRange(const Vec3i& ID) const
+	{
+#ifdef __CUDA_ARCH__
+		const unsigned int MinMax = this->MacroCells(ID);
+#else
+		const unsigned int MinMax = this->HostMacroCells(ID);
+#endif
+
+		return Vec2f((float)(MinMax & 0xFFFF), (float)(MinMax >> 16));
 	}
 
-	BoundingBox					BoundingBox;
-	Vec3f						GradientDeltaX;
-	Vec3f						GradientDeltaY;
-	Vec3f						GradientDeltaZ;
-	Vec3f						Spacing;
-	Vec3f						InvSpacing;
-	Vec3f						Size;
-	Vec3f						InvSize;
-	float						MinStep;
-	Buffer3D<unsigned short>	Voxels;
+	BoundingBox						BoundingBox;
+	Vec3f							GradientDeltaX;
+	Vec3f							GradientDeltaY;
+	Vec3f							GradientDeltaZ;
+	Vec3f							Spacing;
+	Vec3f							InvSpacing;
+	Vec3f							Size;
+	Vec3f							InvSize;
+	float							MinStep;
+	Vec3i							Resolution;
+	Buffer3D<unsigned short>		Voxels;
+	Buffer3D<unsigned short>		HostVoxels;
+	Vec3f							MacroCellSize;
+	Buffer3D<unsigned int>			MacroCells;
+	Buffer3D<unsigned int>			HostMacroCells;
+	float							GradientScale;
+	Buffer3D<unsigned int>			Gradients;
+	Buffer3D<unsigned int>			HostGradients;
+	shared_ptr<Host::MappedFile>	File;
+	shared_ptr<Host::BrickCache>	BrickCache;
 };
 
 }
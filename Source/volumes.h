@@ -70,6 +70,16 @@ HOST_DEVICE_NI Vec3f GradientFiltered(const int& VolumeID, const Vec3f& P)
 
 HOST_DEVICE_NI Vec3f Gradient(const int& VolumeID, const Vec3f& P)
 {
+	if (gpVolumes[VolumeID].HasGradients())
+	{
+		Vec3f Gradient;
+		float Magnitude;
+
+		gpVolumes[VolumeID].GetGradient(P, Gradient, Magnitude);
+
+		return Gradient;
+	}
+
 	switch (gpTracer->RenderSettings.Shading.GradientComputation)
 	{
 		case Enums::ForwardDifferences:	return GradientFD(VolumeID, P);
@@ -87,6 +97,16 @@ HOST_DEVICE_NI Vec3f NormalizedGradient(const int& VolumeID, const Vec3f& P)
 
 HOST_DEVICE_NI float GradientMagnitude(const int& VolumeID, const Vec3f& P)
 {
+	if (gpVolumes[VolumeID].HasGradients())
+	{
+		Vec3f Gradient;
+		float Magnitude;
+
+		gpVolumes[VolumeID].GetGradient(P, Gradient, Magnitude);
+
+		return Magnitude;
+	}
+
 	Vec3f Pts[3][2];
 
 	Pts[0][0] = P + gpVolumes[VolumeID].GradientDeltaX;
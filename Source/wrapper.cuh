@@ -16,7 +16,7 @@
 #include "exception.h"
 #include "log.h"
 
-#ifdef __CUDA_ARCH__
+#ifdef __CUDACC__
 
 #include <cuda.h>
 #include <cuda_runtime_api.h>
@@ -40,6 +40,16 @@ static inline void HandleCudaError(const cudaError_t& CudaError, const char* pTi
 		throw(Exception(Enums::Error, Message));
 }
 
+static inline bool DeviceAvailable()
+{
+	static int NoDevices = -1;
+
+	if (NoDevices < 0 && cudaGetDeviceCount(&NoDevices) != cudaSuccess)
+		NoDevices = 0;
+
+	return NoDevices > 0;
+}
+
 static inline void ThreadSynchronize()
 {
 	Cuda::HandleCudaError(cudaThreadSynchronize(), "cudaThreadSynchronize");
@@ -59,7 +69,7 @@ template<class T> static inline void AllocatePiched(T*& pDevicePointer, const in
 	Cuda::ThreadSynchronize();
 }
 
-template<class T> static inline void MemSet(T*& pDevicePointer, const int Value, int Num = 1)
+template<class T> static inline void MemSet(T*& pDevicePointer, const int Value, long long Num = 1)
 {
 	Cuda::ThreadSynchronize();
 	HandleCudaError(cudaMemset((void*)pDevicePointer, Value, (size_t)(Num * sizeof(T))), "cudaMemset");
@@ -87,21 +97,26 @@ template<class T> static inline void MemCopyDeviceToDeviceSymbol(T* pDevice, con
 	Cuda::ThreadSynchronize();
 }
 
-template<class T> static inline void MemCopyHostToDevice(T* pHost, T* pDevice, int Num = 1)
+template<class T> static inline void MemCopyHostToDevice(T* pHost, T* pDevice, long long Num = 1)
 {
 	Cuda::ThreadSynchronize();
 	HandleCudaError(cudaMemcpy(pDevice, pHost, Num * sizeof(T), cudaMemcpyHostToDevice), "cudaMemcpy");
 	Cuda::ThreadSynchronize();
 }
 
-template<class T> static inline void MemCopyDeviceToHost(T* pDevice, T* pHost, int Num = 1)
+static inline void MemCopyHostToDeviceRange(const void* pHost, void* pDevice, const int& Offset, const int& NoBytes)
+{
+	HandleCudaError(cudaMemcpy((char*)pDevice + Offset, (const char*)pHost + Offset, NoBytes, cudaMemcpyHostToDevice), "cudaMemcpy");
+}
+
+template<class T> static inline void MemCopyDeviceToHost(T* pDevice, T* pHost, long long Num = 1)
 {
 	Cuda::ThreadSynchronize();
 	HandleCudaError(cudaMemcpy(pHost, pDevice, Num * sizeof(T), cudaMemcpyDeviceToHost), "cudaMemcpy");
 	Cuda::ThreadSynchronize();
 }
 
-template<class T> static inline void MemCopyDeviceToDevice(T* pDeviceSource, T* pDeviceDestination, int Num = 1)
+template<class T> static inline void MemCopyDeviceToDevice(T* pDeviceSource, T* pDeviceDestination, long long Num = 1)
 {
 	Cuda::ThreadSynchronize();
 	HandleCudaError(cudaMemcpy(pDeviceDestination, pDeviceSource, Num * sizeof(T), cudaMemcpyDeviceToDevice), "cudaMemcpy");
@@ -139,4 +154,4 @@ static inline void GetSymbolAddress(void** pDevicePointer, char* pSymbol)
 
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file